@@ -3,9 +3,51 @@
 #include <tuple>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <utility>
 #include <type_traits>
 #include <iterator>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <bit>
+#include <new>
+#include <cstring>
+#include <memory_resource>
+#include <numeric>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+
+// HugePageAllocator maps its large allocations directly (Linux/POSIX mmap).
+#if defined(__linux__)
+  #include <sys/mman.h>
+  #define AOSOA_HAS_MMAP 1
+#else
+  #define AOSOA_HAS_MMAP 0
+#endif
+
+// WorkerPool::set_affinity pins threads with sched/pthread affinity masks and
+// reads the NUMA layout from sysfs; elsewhere pinning is a no-op. Cache sizes
+// come from sysconf, with fixed fallbacks.
+#if defined(__linux__)
+  #include <sched.h>
+  #include <pthread.h>
+  #include <unistd.h>
+  #define AOSOA_HAS_AFFINITY 1
+#else
+  #define AOSOA_HAS_AFFINITY 0
+#endif
 
 // AVX2 is required for the opt-in hand-written reductions (sum_all_f32_avx2
 // and compute_all_f32_avx2). Everything else is portable C++20.
@@ -16,6 +58,1156 @@
   #define AOSOA_HAS_AVX2 0
 #endif
 
+// AVX-512F enables the zmm variants of those reductions (sum_all_f32_avx512
+// and compute_all_f32_avx512): one 16-float Block field is one register.
+#if defined(__AVX512F__)
+  #define AOSOA_HAS_AVX512 1
+#else
+  #define AOSOA_HAS_AVX512 0
+#endif
+
+// for_each_simd / reduce_simd are built on the Parallelism TS v2 simd types
+// (libstdc++ 11+). Without <experimental/simd> they are simply not declared.
+#if __has_include(<experimental/simd>)
+  #include <experimental/simd>
+  #define AOSOA_HAS_STDX_SIMD 1
+namespace aosoa_detail { namespace stdx = std::experimental; }
+#else
+  #define AOSOA_HAS_STDX_SIMD 0
+#endif
+
+// Runtime ISA dispatch (sum_all_f32_dispatch / compute_all_f32_dispatch)
+// needs only GCC/Clang on x86: the per-ISA kernels carry their own target
+// attributes, so they are built even when the TU targets baseline x86-64.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #include <immintrin.h>
+  #define AOSOA_HAS_X86_DISPATCH 1
+#else
+  #define AOSOA_HAS_X86_DISPATCH 0
+#endif
+
+// The AVX2 f32 reductions carry their own target attribute under runtime
+// dispatch, so f32_kernel_avx2 can reuse them from a baseline build. In an
+// -mavx2 build the attribute adds nothing.
+#if AOSOA_HAS_X86_DISPATCH
+  #define AOSOA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+  #define AOSOA_TARGET_AVX2
+#endif
+
+// Non-temporal stores for StoreMode::streaming: 256-bit with AVX2, SSE2's
+// 128-bit ones otherwise; without either, streaming is a plain copy.
+#if AOSOA_HAS_AVX2 || (AOSOA_HAS_X86_DISPATCH && defined(__SSE2__))
+  #define AOSOA_HAS_STREAM 1
+#else
+  #define AOSOA_HAS_STREAM 0
+#endif
+
+#if AOSOA_HAS_X86_DISPATCH
+namespace aosoa_detail {
+enum class Isa { scalar, avx2, avx512 };
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::avx512: return "avx512";
+    case Isa::avx2:   return "avx2";
+    default:          return "scalar";
+    }
+}
+
+// Widest kernel set this CPU (and OS) can run. __builtin_cpu_init makes it
+// safe to call from static initializers that run before main.
+inline Isa detect_isa() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::avx2;
+    return Isa::scalar;
+}
+
+// Detected once, on first use.
+inline Isa cpu_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+} // namespace aosoa_detail
+#endif
+
+#if AOSOA_HAS_AVX2
+namespace aosoa_detail {
+// Permutation tables for filter_simd's stream compaction. Row m lists, in
+// order, the lanes whose bit is set in m, then pads with lane 0. The 32-bit
+// table packs 8 x 4-byte lanes; the 64-bit table packs 4 x 8-byte lanes as
+// dword pairs, for use with _mm256_permutevar8x32_epi32.
+inline constexpr auto compact_lut32 = [] {
+    std::array<std::array<uint32_t, 8>, 256> t{};
+    for (unsigned m = 0; m < 256; ++m) {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 8; ++j)
+            if ((m >> j) & 1u) t[m][k++] = j;
+    }
+    return t;
+}();
+
+inline constexpr auto compact_lut64 = [] {
+    std::array<std::array<uint32_t, 8>, 16> t{};
+    for (unsigned m = 0; m < 16; ++m) {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 4; ++j)
+            if ((m >> j) & 1u) { t[m][k++] = 2 * j; t[m][k++] = 2 * j + 1; }
+    }
+    return t;
+}();
+
+// 256-bit vector of accumulator type R for sum_all_avx2 / compute_all_avx2.
+// R is the common type of the fields: float, double or int32_t.
+template<class R> struct vec256;
+
+template<> struct vec256<float> {
+    using V = __m256;
+    static constexpr size_t lanes = 8;
+    static V zero()               { return _mm256_setzero_ps(); }
+    static V add(V a, V b)        { return _mm256_add_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static float hsum(V v) {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_movehdup_ps(s));
+        return _mm_cvtss_f32(s);
+    }
+};
+
+template<> struct vec256<double> {
+    using V = __m256d;
+    static constexpr size_t lanes = 4;
+    static V zero()               { return _mm256_setzero_pd(); }
+    static V add(V a, V b)        { return _mm256_add_pd(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    static double hsum(V v) {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+        return _mm_cvtsd_f64(s);
+    }
+};
+
+template<> struct vec256<int32_t> {
+    using V = __m256i;
+    static constexpr size_t lanes = 8;
+    static V zero()               { return _mm256_setzero_si256(); }
+    static V add(V a, V b)        { return _mm256_add_epi32(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+    static int32_t hsum(V v) {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        s = _mm_add_epi32(s, _mm_unpackhi_epi64(s, s));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x1));
+        return _mm_cvtsi128_si32(s);
+    }
+};
+
+// True when a field of type T can be loaded into a vec256<R>, widening on
+// the way in: int32 -> float, int32 -> double, float -> double.
+template<class R, class T>
+inline constexpr bool widens_to =
+    std::is_same_v<R, T> ||
+    (std::is_same_v<R, double> && (std::is_same_v<T, float> || std::is_same_v<T, int32_t>)) ||
+    (std::is_same_v<R, float>  && std::is_same_v<T, int32_t>);
+
+// Loads vec256<R>::lanes consecutive Ts from p as one vec256<R>. Unaligned
+// loads: the tuple does not promise where each field array starts, and an
+// unaligned load of aligned data costs nothing extra.
+template<class R, class T>
+inline typename vec256<R>::V load_widen(const T* p) {
+    if constexpr (std::is_same_v<R, T>) {
+        if constexpr (std::is_same_v<R, float>)       return _mm256_loadu_ps(p);
+        else if constexpr (std::is_same_v<R, double>) return _mm256_loadu_pd(p);
+        else return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    } else if constexpr (std::is_same_v<R, double> && std::is_same_v<T, float>) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));
+    } else if constexpr (std::is_same_v<R, double>) {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    } else {
+        return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+}
+} // namespace aosoa_detail
+#endif
+
+// WorkerPool: persistent threads behind the *_par traversals.
+//
+// run(T, fn) calls fn(t) for every t in [0, T) and returns once all T calls
+// have finished. t == 0 runs on the calling thread; the others run on parked
+// workers that are spawned lazily the first time a given T is requested and
+// then reused, so a parallel traversal costs one wake-up and one join, not T
+// thread creations. Concurrent run() calls are serialized; calling run() from
+// inside fn on the same pool deadlocks.
+//
+// By default threads float. set_affinity() pins thread t to a fixed CPU, so
+// that the thread which first-touched a block range (resize_par) is the one
+// that later streams it, on the same NUMA node.
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& th : threads_) th.join();
+    }
+
+    // Process-wide pool used by AoSoA's *_par methods.
+    static WorkerPool& global() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    static size_t default_threads() {
+        const unsigned hc = std::thread::hardware_concurrency();
+        return hc == 0 ? 1 : hc;
+    }
+
+    // Pins thread t of every later run() to cpus[t % cpus.size()]: workers
+    // immediately and as they are spawned, the calling thread (t == 0) on
+    // its next run(), after which it stays pinned. An empty list restores
+    // the mask the process had before the first call. Not thread-safe
+    // against a concurrent run() from another thread.
+    void set_affinity(std::vector<int> cpus) {
+        std::lock_guard<std::mutex> serial(run_mtx_);
+#if AOSOA_HAS_AFFINITY
+        if (!saved_mask_) {
+            saved_mask_ = std::make_unique<cpu_set_t>();
+            sched_getaffinity(0, sizeof(cpu_set_t), saved_mask_.get());
+        }
+        cpus_ = std::move(cpus);
+        for (size_t i = 0; i < threads_.size(); ++i) pin(threads_[i].native_handle(), i + 1);
+        pinned_caller_ = std::thread::id{};
+        pinned_.store(true, std::memory_order_relaxed);
+#else
+        (void)cpus;
+#endif
+    }
+
+    // CPUs this process may run on, ordered round-robin over NUMA nodes
+    // (node 0's first CPU, node 1's first CPU, ..., node 0's second CPU, ...),
+    // so T pinned threads spread over every node's memory controllers rather
+    // than filling one socket first. One node, or no sysfs, gives the allowed
+    // CPUs in order. Empty when affinity is unsupported.
+    static std::vector<int> spread_cpus() {
+        std::vector<int> out;
+#if AOSOA_HAS_AFFINITY
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return out;
+        std::vector<std::vector<int>> nodes;
+        for (int node = 0;; ++node) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) break;
+            std::vector<int> cpus = read_cpulist(in, allowed);
+            if (!cpus.empty()) nodes.push_back(std::move(cpus));
+        }
+        if (nodes.empty()) {
+            for (int c = 0; c < CPU_SETSIZE; ++c)
+                if (CPU_ISSET(c, &allowed)) out.push_back(c);
+            return out;
+        }
+        for (size_t k = 0;; ++k) {
+            bool any = false;
+            for (const auto& n : nodes)
+                if (k < n.size()) { out.push_back(n[k]); any = true; }
+            if (!any) break;
+        }
+#endif
+        return out;
+    }
+
+    // The hyperthreads sharing a core with `cpu` (cpu itself included), as
+    // far as this process may use them: {cpu} without SMT, empty when
+    // affinity is unsupported. set_affinity(smt_siblings(c)) runs a
+    // two-thread run() on one physical core, e.g. for
+    // sum_all_f32_avx2_helper.
+    static std::vector<int> smt_siblings(int cpu) {
+        std::vector<int> out;
+#if AOSOA_HAS_AFFINITY
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return out;
+        std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+        if (in) out = read_cpulist(in, allowed);
+        if (out.empty() && cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) out.push_back(cpu);
+#else
+        (void)cpu;
+#endif
+        return out;
+    }
+
+    // Number of NUMA nodes with CPUs this process may use (1 without sysfs).
+    static size_t numa_nodes() {
+        size_t n = 0;
+#if AOSOA_HAS_AFFINITY
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 1;
+        for (int node = 0;; ++node) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) break;
+            if (!read_cpulist(in, allowed).empty()) ++n;
+        }
+#endif
+        return std::max<size_t>(n, 1);
+    }
+
+    template<class Fn>
+    void run(size_t nthreads, Fn&& fn) {
+        if (nthreads <= 1 && !pinned_.load(std::memory_order_relaxed)) { fn(size_t{0}); return; }
+        std::lock_guard<std::mutex> serial(run_mtx_);
+        pin_caller();
+        if (nthreads <= 1) { fn(size_t{0}); return; }
+        spawn_workers(nthreads - 1);
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            job_ = [](void* ctx, size_t t) {
+                (*static_cast<std::remove_reference_t<Fn>*>(ctx))(t);
+            };
+            ctx_     = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+            active_  = nthreads;
+            pending_ = nthreads - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+        fn(size_t{0});
+        std::unique_lock<std::mutex> lk(mtx_);
+        done_.wait(lk, [&] { return pending_ == 0; });
+    }
+
+private:
+    void spawn_workers(size_t n) {
+        while (threads_.size() < n) {
+            const size_t id = threads_.size() + 1;
+            threads_.emplace_back([this, id] { worker_loop(id); });
+#if AOSOA_HAS_AFFINITY
+            if (saved_mask_) pin(threads_.back().native_handle(), id);
+#endif
+        }
+    }
+
+#if AOSOA_HAS_AFFINITY
+    // Parses a sysfs CPU list ("0-3,8-11") from `in`, keeping allowed CPUs.
+    static std::vector<int> read_cpulist(std::istream& in, const cpu_set_t& allowed) {
+        std::vector<int> cpus;
+        std::string list;
+        std::getline(in, list);
+        size_t pos = 0;
+        while (pos < list.size()) {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos) end = list.size();
+            const std::string item = list.substr(pos, end - pos);
+            const size_t dash = item.find('-');
+            if (!item.empty()) {
+                const int lo = std::stoi(item.substr(0, dash));
+                const int hi = (dash == std::string::npos) ? lo : std::stoi(item.substr(dash + 1));
+                for (int c = lo; c <= hi; ++c)
+                    if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+            }
+            pos = end + 1;
+        }
+        return cpus;
+    }
+
+    // Thread t's mask: cpus_[t % size], or the saved mask once unpinned.
+    void pin(pthread_t th, size_t t) const {
+        cpu_set_t set;
+        if (cpus_.empty()) {
+            set = *saved_mask_;
+        } else {
+            CPU_ZERO(&set);
+            CPU_SET(cpus_[t % cpus_.size()], &set);
+        }
+        pthread_setaffinity_np(th, sizeof(set), &set);
+    }
+#endif
+
+    // Called under run_mtx_; pins the calling thread as t == 0 if needed.
+    void pin_caller() {
+#if AOSOA_HAS_AFFINITY
+        if (!saved_mask_ || pinned_caller_ == std::this_thread::get_id()) return;
+        pin(pthread_self(), 0);
+        pinned_caller_ = std::this_thread::get_id();
+        if (cpus_.empty()) pinned_.store(false, std::memory_order_relaxed);
+#endif
+    }
+
+    void worker_loop(size_t id) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lk(mtx_);
+        for (;;) {
+            wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            if (id >= active_) continue;
+            void (*job)(void*, size_t) = job_;
+            void* ctx = ctx_;
+            lk.unlock();
+            job(ctx, id);
+            lk.lock();
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    std::mutex run_mtx_;
+    std::mutex mtx_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::vector<std::thread> threads_;
+    void (*job_)(void*, size_t) = nullptr;
+    void* ctx_       = nullptr;
+    size_t active_   = 0;
+    size_t pending_  = 0;
+    uint64_t generation_ = 0;
+    bool stop_       = false;
+#if AOSOA_HAS_AFFINITY
+    std::vector<int> cpus_;
+    std::unique_ptr<cpu_set_t> saved_mask_;
+    std::thread::id pinned_caller_;
+#endif
+    std::atomic<bool> pinned_{false};
+};
+
+// HugePageAllocator: backs allocations of 2 MiB or more with 2 MiB pages, to
+// cut the dTLB misses of streaming over large containers (a 4 KiB-page
+// walk over a 32 MiB float8 AoSoA touches 8192 pages; 2 MiB pages make it
+// 16). It first asks for explicit huge pages (MAP_HUGETLB, which needs a
+// reserved vm.nr_hugepages pool); if the pool is empty it maps 2 MiB-aligned
+// anonymous memory and marks it MADV_HUGEPAGE so transparent huge pages can
+// back it, which works whenever THP is in "madvise" or "always" mode. Below
+// the threshold, and on non-Linux builds, it is plain aligned operator new.
+//
+// Stateless: any two instances compare equal. Mapped lengths are rounded up
+// to whole huge pages, so deallocate(p, n) can recompute them from n.
+template<class T>
+struct HugePageAllocator {
+    using value_type = T;
+    static constexpr size_t huge_page_size = size_t{2} << 20;
+
+    HugePageAllocator() noexcept = default;
+    template<class U> HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+#if AOSOA_HAS_MMAP
+        if (bytes >= huge_page_size) return static_cast<T*>(map_huge(mapped_length(bytes)));
+#endif
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+#if AOSOA_HAS_MMAP
+        if (bytes >= huge_page_size) { munmap(p, mapped_length(bytes)); return; }
+#endif
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    template<class U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+
+private:
+    static size_t mapped_length(size_t bytes) {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+#if AOSOA_HAS_MMAP
+    static void* map_huge(size_t len) {
+        constexpr int prot  = PROT_READ | PROT_WRITE;
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+        void* p = mmap(nullptr, len, prot, flags | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) return p;
+#endif
+        // Over-map by one huge page, then trim both ends so that exactly
+        // [aligned, aligned + len) stays mapped and munmap(p, len) frees it.
+        char* raw = static_cast<char*>(mmap(nullptr, len + huge_page_size, prot, flags, -1, 0));
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+        const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+        char* aligned = reinterpret_cast<char*>((base + huge_page_size - 1) & ~(huge_page_size - 1));
+        const size_t head = static_cast<size_t>(aligned - raw);
+        if (head > 0) munmap(raw, head);
+        munmap(aligned + len, huge_page_size - head);
+#ifdef MADV_HUGEPAGE
+        madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+        return aligned;
+    }
+#endif
+};
+
+// FrameArena: a bump-pointer std::pmr::memory_resource for per-frame
+// temporaries (filter outputs, scratch containers). Allocation is a pointer
+// bump in one contiguous buffer; deallocate is a no-op; reset() drops
+// everything at once. Use it through std::pmr::polymorphic_allocator, e.g.
+//
+//     FrameArena arena;
+//     using PA = BasicAoSoA<16, std::pmr::polymorphic_allocator<std::byte>, float, float>;
+//     PA particles;                           // long-lived, default resource
+//     for (;;) {
+//         arena.reset();                      // last frame's temporaries are gone
+//         auto alive = particles.filter(pred, &arena);
+//         ...
+//     }
+//
+// When a frame needs more than the buffer holds, the excess comes from the
+// upstream resource in separate chunks; the next reset() frees them and
+// regrows the buffer to that frame's high-water mark, so after warm-up a
+// steady frame touches the upstream resource zero times. Everything
+// allocated from the arena must be destroyed before reset(). Not thread-safe.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t buffer_alignment = 64;
+
+    explicit FrameArena(size_t initial_bytes = size_t{1} << 20,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream) {
+        grow(initial_bytes);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    ~FrameArena() override {
+        release_overflow();
+        if (buf_) upstream_->deallocate(buf_, cap_, buffer_alignment);
+    }
+
+    // Invalidates every allocation made since the previous reset().
+    void reset() {
+        const size_t demand = used_ + overflow_bytes_;
+        release_overflow();
+        if (demand > cap_) grow(demand);
+        used_ = 0;
+    }
+
+    size_t capacity() const   { return cap_; }
+    size_t bytes_used() const { return used_ + overflow_bytes_; }
+    size_t high_water() const { return high_water_; }
+
+private:
+    struct Chunk { void* p; size_t bytes; size_t align; };
+
+    void* do_allocate(size_t bytes, size_t align) override {
+        const size_t at = (used_ + align - 1) & ~(align - 1);
+        if (align <= buffer_alignment && at + bytes <= cap_) {
+            used_ = at + bytes;
+            high_water_ = std::max(high_water_, bytes_used());
+            return buf_ + at;
+        }
+        void* p = upstream_->allocate(bytes, align);
+        overflow_.push_back(Chunk{p, bytes, align});
+        overflow_bytes_ += bytes + align;
+        high_water_ = std::max(high_water_, bytes_used());
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void grow(size_t bytes) {
+        if (buf_) upstream_->deallocate(buf_, cap_, buffer_alignment);
+        buf_ = nullptr;
+        cap_ = 0;
+        const size_t want = (bytes + buffer_alignment - 1) & ~(buffer_alignment - 1);
+        buf_ = static_cast<std::byte*>(upstream_->allocate(want, buffer_alignment));
+        cap_ = want;
+    }
+
+    void release_overflow() {
+        for (const Chunk& c : overflow_) upstream_->deallocate(c.p, c.bytes, c.align);
+        overflow_.clear();
+        overflow_bytes_ = 0;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::byte* buf_ = nullptr;
+    size_t cap_  = 0;
+    size_t used_ = 0;
+    size_t overflow_bytes_ = 0;
+    size_t high_water_ = 0;
+    std::vector<Chunk> overflow_;
+};
+
+// SegmentedStorage<Alloc, PageBytes>: pass it in place of the allocator
+// (BasicAoSoA<B, SegmentedStorage<>, Ts...>) to keep the blocks in fixed-size
+// pages behind a page table instead of one std::vector. Growth then
+// allocates a new page and never relocates existing blocks: no
+// whole-dataset memmove on a capacity doubling, and block / element
+// references stay valid across push_back and resize. Alloc supplies the
+// pages; the 2 MiB default page pairs with HugePageAllocator (one huge page
+// per page). Memory past size() in the last page is reserved, not touched.
+template<class Alloc = std::allocator<std::byte>, size_t PageBytes = size_t{2} << 20>
+struct SegmentedStorage {};
+
+// The page-table container behind SegmentedStorage. Only the subset of
+// std::vector that AoSoA uses: operator[], size / empty / back, resize,
+// reserve, emplace_back, begin / end. Pages hold a power-of-two number of
+// blocks, so operator[] is a shift, a mask and one page-table load.
+template<class T, class Alloc, size_t PageBytes>
+class SegmentedBlockStore {
+public:
+    using value_type     = T;
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    static constexpr size_t page_blocks = std::bit_floor(std::max<size_t>(1, PageBytes / sizeof(T)));
+    static constexpr size_t page_shift  = static_cast<size_t>(std::countr_zero(page_blocks));
+    static constexpr size_t page_mask   = page_blocks - 1;
+
+    template<bool Const>
+    class basic_iterator {
+        using store_t = std::conditional_t<Const, const SegmentedBlockStore, SegmentedBlockStore>;
+        store_t* s_ = nullptr;
+        size_t i_ = 0;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const T&, T&>;
+        using pointer           = std::conditional_t<Const, const T*, T*>;
+
+        basic_iterator() = default;
+        basic_iterator(store_t* s, size_t i) : s_(s), i_(i) {}
+
+        reference operator*() const                  { return (*s_)[i_]; }
+        pointer operator->() const                   { return &(*s_)[i_]; }
+        reference operator[](difference_type k) const { return (*s_)[i_ + k]; }
+        basic_iterator& operator++()                 { ++i_; return *this; }
+        basic_iterator operator++(int)               { auto t = *this; ++i_; return t; }
+        basic_iterator& operator--()                 { --i_; return *this; }
+        basic_iterator operator--(int)               { auto t = *this; --i_; return t; }
+        basic_iterator& operator+=(difference_type k) { i_ += k; return *this; }
+        basic_iterator& operator-=(difference_type k) { i_ -= k; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type k) { return it += k; }
+        friend basic_iterator operator+(difference_type k, basic_iterator it) { return it += k; }
+        friend basic_iterator operator-(basic_iterator it, difference_type k) { return it -= k; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) {
+            return static_cast<difference_type>(a.i_) - static_cast<difference_type>(b.i_);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.i_ == b.i_; }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) { return a.i_ <=> b.i_; }
+    };
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    SegmentedBlockStore() = default;
+    explicit SegmentedBlockStore(const allocator_type& a) : alloc_(a) {}
+
+    SegmentedBlockStore(const SegmentedBlockStore& o)
+        : SegmentedBlockStore(o, traits::select_on_container_copy_construction(o.alloc_)) {}
+    // Delegates, so the object is complete before the first page is
+    // allocated: if a later allocation or copy throws, the destructor
+    // frees the pages and blocks made so far.
+    SegmentedBlockStore(const SegmentedBlockStore& o, const allocator_type& a)
+        : SegmentedBlockStore(a) {
+        reserve(o.size_);
+        for (size_t i = 0; i < o.size_; ++i) {
+            traits::construct(alloc_, &(*this)[i], o[i]);
+            ++size_;
+        }
+    }
+    SegmentedBlockStore(SegmentedBlockStore&& o) noexcept
+        : alloc_(o.alloc_), pages_(std::move(o.pages_)), size_(o.size_) {
+        o.pages_.clear();
+        o.size_ = 0;
+    }
+
+    // The allocator follows the propagate_on_container_* traits as in the
+    // standard containers. A copy is built with the allocator this store
+    // ends up with, so each page is always freed by the one that made it.
+    SegmentedBlockStore& operator=(const SegmentedBlockStore& o) {
+        if (this == &o) return *this;
+        constexpr bool pocca = traits::propagate_on_container_copy_assignment::value;
+        SegmentedBlockStore t(o, pocca ? o.alloc_ : alloc_);
+        take_storage(t, std::bool_constant<pocca>{});
+        return *this;
+    }
+    SegmentedBlockStore& operator=(SegmentedBlockStore&& o)
+        noexcept(traits::propagate_on_container_move_assignment::value ||
+                 traits::is_always_equal::value) {
+        if (this == &o) return *this;
+        constexpr bool pocma = traits::propagate_on_container_move_assignment::value;
+        if constexpr (!pocma && !traits::is_always_equal::value) {
+            // o's pages cannot be adopted; copy its blocks into ours.
+            if (alloc_ != o.alloc_) {
+                SegmentedBlockStore t(o, alloc_);
+                take_storage(t, std::false_type{});
+                return *this;
+            }
+        }
+        SegmentedBlockStore t(std::move(o));
+        take_storage(t, std::bool_constant<pocma>{});
+        return *this;
+    }
+    ~SegmentedBlockStore() {
+        clear();
+        for (T* p : pages_) traits::deallocate(alloc_, p, page_blocks);
+    }
+
+    // Allocators are exchanged only when they propagate on swap; otherwise,
+    // as for std::vector, they must compare equal.
+    void swap(SegmentedBlockStore& o) noexcept {
+        take_storage(o, std::bool_constant<traits::propagate_on_container_swap::value>{});
+    }
+
+    allocator_type get_allocator() const { return alloc_; }
+
+    T& operator[](size_t i)             { return pages_[i >> page_shift][i & page_mask]; }
+    const T& operator[](size_t i) const { return pages_[i >> page_shift][i & page_mask]; }
+
+    size_t size() const      { return size_; }
+    bool empty() const       { return size_ == 0; }
+    size_t capacity() const  { return pages_.size() * page_blocks; }
+    size_t num_pages() const { return pages_.size(); }
+
+    T& back()             { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    iterator begin()             { return {this, 0}; }
+    iterator end()               { return {this, size_}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const   { return {this, size_}; }
+
+    // Adds pages only; no existing block moves.
+    void reserve(size_t n) {
+        const size_t need = (n + page_blocks - 1) >> page_shift;
+        if (need <= pages_.size()) return;
+        pages_.reserve(need);
+        while (pages_.size() < need) {
+            pages_.push_back(traits::allocate(alloc_, page_blocks));
+        }
+    }
+
+    void resize(size_t n) {
+        if (n > size_) {
+            reserve(n);
+            for (; size_ < n; ++size_) {
+                traits::construct(alloc_, &(*this)[size_]);
+            }
+        } else {
+            while (size_ > n) {
+                --size_;
+                traits::destroy(alloc_, &(*this)[size_]);
+            }
+        }
+    }
+
+    T& emplace_back() {
+        if (size_ == capacity()) reserve(size_ + 1);
+        T* p = &(*this)[size_];
+        traits::construct(alloc_, p);
+        ++size_;
+        return *p;
+    }
+
+    void clear() { resize(0); }
+
+private:
+    using traits = std::allocator_traits<allocator_type>;
+
+    // Exchanges pages and size with o, and the allocators too if Alloc.
+    template<bool WithAlloc>
+    void take_storage(SegmentedBlockStore& o, std::bool_constant<WithAlloc>) noexcept {
+        using std::swap;
+        if constexpr (WithAlloc) swap(alloc_, o.alloc_);
+        pages_.swap(o.pages_);
+        swap(size_, o.size_);
+    }
+
+    [[no_unique_address]] allocator_type alloc_{};
+    std::vector<T*> pages_;
+    size_t size_ = 0;
+};
+
+namespace aosoa_detail {
+// Bulk element copy for the append paths: memcpy when T allows it.
+template<class T>
+inline void copy_elems(T* dst, const T* src, size_t n) {
+    if constexpr (std::is_trivially_copyable_v<T>) std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+    else std::copy_n(src, n, dst);
+}
+
+// Per-core L2 size, read once (1 MiB when the system does not say).
+inline size_t l2_cache_bytes() {
+    static const size_t bytes = [] {
+        long v = 0;
+#if AOSOA_HAS_AFFINITY && defined(_SC_LEVEL2_CACHE_SIZE)
+        v = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+        return v > 0 ? static_cast<size_t>(v) : size_t{1} << 20;
+    }();
+    return bytes;
+}
+
+// Last-level cache size, read once (8 MiB when the system does not say).
+inline size_t llc_cache_bytes() {
+    static const size_t bytes = [] {
+        long v = 0;
+#if AOSOA_HAS_AFFINITY && defined(_SC_LEVEL3_CACHE_SIZE)
+        v = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        return v > 0 ? static_cast<size_t>(v) : size_t{8} << 20;
+    }();
+    return bytes;
+}
+} // namespace aosoa_detail
+
+// How transform / filter write their output. normal stores go through the
+// cache; streaming uses non-temporal stores, which write whole lines to DRAM
+// without reading them first or evicting the input. automatic streams when
+// the output is at least half the LLC: an output that size would push the
+// input working set out of cache for no benefit, since nothing reads it in
+// the same pass.
+enum class StoreMode { automatic, normal, streaming };
+
+namespace aosoa_detail {
+inline bool use_streaming(StoreMode mode, size_t out_bytes) {
+    if (mode == StoreMode::automatic) return out_bytes >= llc_cache_bytes() / 2;
+    return mode == StoreMode::streaming;
+}
+
+// Copies n bytes from src to dst with non-temporal stores where dst is
+// vector-aligned, plain copies for the unaligned head and tail. Call
+// stream_fence() once after the last stream_copy of an output. n may be 0,
+// with dst then possibly null (an empty output's data()).
+inline void stream_copy(void* dst, const void* src, size_t n) {
+    if (n == 0) return;
+    auto* d = static_cast<char*>(dst);
+    const auto* s = static_cast<const char*>(src);
+#if AOSOA_HAS_STREAM
+  #if AOSOA_HAS_AVX2
+    using V = __m256i;
+  #else
+    using V = __m128i;
+  #endif
+    const size_t head = std::min(n, (sizeof(V) - reinterpret_cast<uintptr_t>(d) % sizeof(V)) % sizeof(V));
+    std::memcpy(d, s, head);
+    size_t i = head;
+    for (; i + sizeof(V) <= n; i += sizeof(V)) {
+  #if AOSOA_HAS_AVX2
+        _mm256_stream_si256(reinterpret_cast<V*>(d + i), _mm256_loadu_si256(reinterpret_cast<const V*>(s + i)));
+  #else
+        _mm_stream_si128(reinterpret_cast<V*>(d + i), _mm_loadu_si128(reinterpret_cast<const V*>(s + i)));
+  #endif
+    }
+    std::memcpy(d + i, s + i, n - i);
+#else
+    std::memcpy(d, s, n);
+#endif
+}
+
+// Orders the non-temporal stores before any later store, so the output is
+// complete for whoever is handed it next.
+inline void stream_fence() {
+#if AOSOA_HAS_STREAM
+    _mm_sfence();
+#endif
+}
+
+// Block container for BasicAoSoA's Alloc slot: a plain allocator gives a
+// std::vector, SegmentedStorage the page-table store.
+template<class Alloc, class BlockT>
+struct block_store {
+    using type = std::vector<BlockT, typename std::allocator_traits<Alloc>::template rebind_alloc<BlockT>>;
+    static constexpr bool contiguous = true;
+};
+template<class Alloc, size_t PageBytes, class BlockT>
+struct block_store<SegmentedStorage<Alloc, PageBytes>, BlockT> {
+    using type = SegmentedBlockStore<BlockT, Alloc, PageBytes>;
+    static constexpr bool contiguous = false;
+};
+} // namespace aosoa_detail
+
+// Autotuner: picks the for_each traversal on this machine.
+//
+// The header's tuned defaults (B=16, UNROLL=4 when L3-resident, K=8 at 1M)
+// were found on one CPU with a 12 MiB L3. for_each_auto measures instead:
+// for each (op, type config, size class) it times for_each,
+// for_each_unrolled<2/4/8> and for_each_multistream<4/8/16> on the caller's
+// own kernel and keeps the fastest. The size class is the working set
+// against the cache sizes read at startup: "l2", "llc" or "dram". B is a
+// template parameter, so it is part of the type config rather than a
+// choice; compare AoSoAAuto / AoSoAFit configs to pick it.
+//
+// Calibration is online. While a key is open, each call runs the next
+// candidate in turn (round-robin, so drift hits them all alike), timed,
+// and does its real work; after a warm-up round and `trials` more, the
+// minimum ns/element wins. A tuner given a file writes its decisions there,
+// one per line:
+//
+//   # aosoa-tune l2=<bytes> llc=<bytes>
+//   <op> <config> <size class> <strategy> <ns/element>
+//
+// and reads them back on first use, unless the cache sizes in the header
+// differ from this machine's, so later runs dispatch straight away. Fields
+// are whitespace-separated, so op must be a single token. Thread-safe.
+class Autotuner {
+public:
+    enum class Strategy : uint8_t { plain, unroll2, unroll4, unroll8, stream4, stream8, stream16 };
+    static constexpr size_t strategy_count = 7;
+
+    static const char* strategy_name(Strategy s) {
+        constexpr const char* names[strategy_count] = {
+            "for_each", "unrolled2", "unrolled4", "unrolled8",
+            "multistream4", "multistream8", "multistream16" };
+        return names[static_cast<size_t>(s)];
+    }
+
+    // An empty path keeps the decisions in memory only.
+    explicit Autotuner(std::string path, size_t trials = 3)
+        : path_(std::move(path)), trials_(std::max<size_t>(trials, 1)) {}
+    Autotuner(const Autotuner&) = delete;
+    Autotuner& operator=(const Autotuner&) = delete;
+
+    // Process-wide tuner used by for_each_auto. It persists only when
+    // $AOSOA_TUNE_FILE names a file; otherwise every process recalibrates.
+    static Autotuner& global() {
+        static Autotuner tuner([] {
+            const char* env = std::getenv("AOSOA_TUNE_FILE");
+            return std::string(env ? env : "");
+        }());
+        return tuner;
+    }
+
+    const std::string& path() const { return path_; }
+
+    // Calls a key needs before its choice is made.
+    size_t calibration_calls() const { return (trials_ + 1) * strategy_count; }
+
+    static const char* size_class(size_t bytes) {
+        constexpr const char* names[] = { "l2", "llc", "dram" };
+        return names[size_class_index(bytes)];
+    }
+
+    // What the next call for (op, config, working-set bytes) should run;
+    // timed is true while that key is still calibrating, and the caller
+    // then reports back via record().
+    //
+    // A settled key is answered from a per-thread cache, with no lock and
+    // no allocation; the key string and the table are only for keys still
+    // calibrating and for each thread's first call after one settles. The
+    // key string is built in here, out of line: a std::string alive in
+    // for_each_auto around the caller's loop keeps GCC from holding a
+    // captured accumulator in a register (4-5x slower at 32K elements).
+    struct Pick { Strategy strategy; bool timed; };
+    __attribute__((noinline))
+    Pick next(std::string_view op, std::string_view config, size_t bytes) {
+        const uint8_t cls = size_class_index(bytes);
+        const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        for (const Settled& c : settled_cache()) {
+            if (c.epoch == epoch && c.cls == cls && c.op == op && c.config == config) {
+                return { c.choice, false };
+            }
+        }
+        const std::string k = key(op, config, bytes);
+        std::lock_guard<std::mutex> lk(mtx_);
+        load_locked();
+        Entry& e = table_[k];
+        if (!e.done) return { static_cast<Strategy>(e.calls % strategy_count), true };
+        remember(epoch_.load(std::memory_order_relaxed), cls, op, config, e.choice);
+        return { e.choice, false };
+    }
+
+    __attribute__((noinline))
+    void record(std::string_view op, std::string_view config, size_t bytes,
+                Strategy s, double ns_per_element) {
+        const std::string k = key(op, config, bytes);
+        std::lock_guard<std::mutex> lk(mtx_);
+        Entry& e = table_[k];
+        if (e.done) return;
+        // Round 0 only warms caches and code; rounds 1..trials count.
+        if (e.calls >= strategy_count) {
+            double& best = e.best[static_cast<size_t>(s)];
+            if (e.calls < 2 * strategy_count || ns_per_element < best) best = ns_per_element;
+        }
+        if (++e.calls < calibration_calls()) return;
+        size_t w = 0;
+        for (size_t i = 1; i < strategy_count; ++i) if (e.best[i] < e.best[w]) w = i;
+        e.choice = static_cast<Strategy>(w);
+        e.ns = e.best[w];
+        e.done = true;
+        save_locked();
+    }
+
+    std::optional<Strategy> chosen(std::string_view op, std::string_view config, size_t bytes) {
+        const std::string k = key(op, config, bytes);
+        std::lock_guard<std::mutex> lk(mtx_);
+        load_locked();
+        auto it = table_.find(k);
+        if (it == table_.end() || !it->second.done) return std::nullopt;
+        return it->second.choice;
+    }
+
+    // Forget every decision, in memory and on disk.
+    void reset() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        table_.clear();
+        loaded_ = true;
+        epoch_.store(new_epoch(), std::memory_order_release);   // orphans every thread's cache
+        if (!path_.empty()) std::remove(path_.c_str());
+    }
+
+private:
+    struct Entry {
+        std::array<double, strategy_count> best{};
+        size_t calls = 0;
+        Strategy choice = Strategy::plain;
+        double ns = 0;
+        bool done = false;
+    };
+
+    // A decision as next() caches it per thread. epoch names the tuner and
+    // its last reset(), so entries of another tuner or of a reset one never
+    // match.
+    struct Settled {
+        uint64_t epoch;
+        uint8_t cls;
+        Strategy choice;
+        std::string op, config;
+    };
+
+    static std::vector<Settled>& settled_cache() {
+        thread_local std::vector<Settled> cache;
+        return cache;
+    }
+
+    // Bounded: a thread that cycles through many keys starts over rather
+    // than scanning an ever longer list.
+    static void remember(uint64_t epoch, uint8_t cls, std::string_view op,
+                         std::string_view config, Strategy choice) {
+        auto& cache = settled_cache();
+        if (cache.size() == 32) cache.clear();
+        cache.push_back({ epoch, cls, choice, std::string(op), std::string(config) });
+    }
+
+    static uint64_t new_epoch() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static uint8_t size_class_index(size_t bytes) {
+        if (bytes <= aosoa_detail::l2_cache_bytes()) return 0;
+        if (bytes <= aosoa_detail::llc_cache_bytes()) return 1;
+        return 2;
+    }
+
+    // op becomes one field of a whitespace-separated line on disk.
+    static std::string key(std::string_view op, std::string_view config, size_t bytes) {
+        if (op.empty() || op.find_first_of(" \t\n\r\v\f") != std::string_view::npos) {
+            throw std::invalid_argument("Autotuner: op must be a non-empty token without whitespace");
+        }
+        std::string k(op);
+        k += ' ';
+        k += config;
+        k += ' ';
+        k += size_class(bytes);
+        return k;
+    }
+
+    static std::string header() {
+        return "# aosoa-tune l2=" + std::to_string(aosoa_detail::l2_cache_bytes()) +
+               " llc=" + std::to_string(aosoa_detail::llc_cache_bytes());
+    }
+
+    void load_locked() {
+        if (loaded_) return;
+        loaded_ = true;
+        if (path_.empty()) return;
+        std::ifstream in(path_);
+        std::string line;
+        if (!std::getline(in, line) || line != header()) return;   // other machine, or no file
+        std::string op, config, cls, strat;
+        double ns;
+        while (in >> op >> config >> cls >> strat >> ns) {
+            for (size_t i = 0; i < strategy_count; ++i) {
+                if (strat != strategy_name(static_cast<Strategy>(i))) continue;
+                Entry& e = table_[op + ' ' + config + ' ' + cls];
+                e.choice = static_cast<Strategy>(i);
+                e.ns = ns;
+                e.done = true;
+            }
+        }
+    }
+
+    // Rewrites the whole file through a temporary, so a reader never sees
+    // half of it. Failures are ignored: the choice still holds in memory.
+    void save_locked() const {
+        if (path_.empty()) return;
+        const std::string tmp = path_ + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out) return;
+            out << header() << '\n';
+            for (const auto& [k, e] : table_) {
+                if (e.done) out << k << ' ' << strategy_name(e.choice) << ' ' << e.ns << '\n';
+            }
+            if (!out) return;
+        }
+        std::rename(tmp.c_str(), path_.c_str());
+    }
+
+    std::string path_;
+    size_t trials_;
+    std::mutex mtx_;
+    bool loaded_ = false;
+    std::unordered_map<std::string, Entry> table_;
+    std::atomic<uint64_t> epoch_{new_epoch()};
+};
+
+// Execution policies for the policy overloads of for_each / reduce / filter.
+// Each knob is a compile-time constant, and policies compose with |:
+//
+//   aosoa.for_each(policy::unroll<4> | policy::streams<8> | policy::prefetch<8>,
+//                  fields<3, 4, 5>, f);
+//
+//   unroll<U>    U consecutive blocks per outer iteration (for_each_unrolled)
+//   streams<K>   K far-apart segments walked in lockstep (for_each_multistream)
+//   prefetch<D>  software prefetch of the lines the pass reads, D blocks
+//                ahead in each stream; 0 leaves it to the hardware
+//
+// All three drive one traversal core, so any combination yields the same
+// loop the hand-written variants did. Combining two policies that both set
+// a knob to different values does not compile.
+namespace policy {
+template<size_t U = 1, size_t K = 1, size_t D = 0>
+struct Exec {
+    static_assert(U >= 1, "unroll must be >= 1");
+    static_assert(K >= 1, "streams must be >= 1");
+    static constexpr size_t unroll   = U;
+    static constexpr size_t streams  = K;
+    static constexpr size_t prefetch = D;
+};
+
+template<size_t U1, size_t K1, size_t D1, size_t U2, size_t K2, size_t D2>
+constexpr auto operator|(Exec<U1, K1, D1>, Exec<U2, K2, D2>) {
+    static_assert(U1 == 1 || U2 == 1 || U1 == U2, "conflicting unroll policies");
+    static_assert(K1 == 1 || K2 == 1 || K1 == K2, "conflicting streams policies");
+    static_assert(D1 == 0 || D2 == 0 || D1 == D2, "conflicting prefetch policies");
+    return Exec<std::max(U1, U2), std::max(K1, K2), std::max(D1, D2)>{};
+}
+
+inline constexpr Exec<> seq{};
+template<size_t U> inline constexpr Exec<U, 1, 0> unroll{};
+template<size_t K> inline constexpr Exec<1, K, 0> streams{};
+template<size_t D> inline constexpr Exec<1, 1, D> prefetch{};
+
+template<class P> inline constexpr bool is_exec_v = false;
+template<size_t U, size_t K, size_t D> inline constexpr bool is_exec_v<Exec<U, K, D>> = true;
+} // namespace policy
+
+// Field selection for the policy overloads: the lambda receives only these
+// fields, in this order, like for_each_field<Is...>.
+template<size_t... Is>
+struct FieldSelect {};
+template<size_t... Is> inline constexpr FieldSelect<Is...> fields{};
+
 // Block: one SOA tile of fixed capacity B, stored inline.
 template<size_t B, typename... Ts>
 struct alignas(64) Block {
@@ -36,19 +1228,33 @@ struct alignas(64) Block {
 // for_each_block is the power-user escape hatch: you get the raw Block and a
 // valid-element count, and can write any custom traversal (e.g. split arrays
 // into per-field locals, hand-fuse loops) without giving up the container.
-template<size_t B, typename... Ts>
-class AoSoA {
+//
+// Alloc is rebound to BlockT for the block vector. AoSoA<B, Ts...> below is
+// the std::allocator instance; BasicAoSoA<B, HugePageAllocator<std::byte>,
+// Ts...> backs large containers with 2 MiB pages, and
+// std::pmr::polymorphic_allocator<std::byte> lets a container draw from any
+// memory_resource, such as a FrameArena. Alloc may also be
+// SegmentedStorage<A, PageBytes>, which swaps the vector for a paged block
+// store that never relocates blocks on growth (SegmentedAoSoA below).
+template<size_t B, class Alloc, typename... Ts>
+class BasicAoSoA {
     static_assert(B > 0, "Block size must be positive");
 public:
     using BlockT = Block<B, Ts...>;
-    std::vector<BlockT> blocks;
+    using block_store_type = typename aosoa_detail::block_store<Alloc, BlockT>::type;
+    using allocator_type = typename block_store_type::allocator_type;
+    block_store_type blocks;
     size_t size_ = 0;
 
     static constexpr size_t block_size()  { return B; }
     static constexpr size_t field_count() { return sizeof...(Ts); }
 
-    AoSoA() = default;
-    explicit AoSoA(size_t n) { resize(n); }
+    BasicAoSoA() = default;
+    explicit BasicAoSoA(size_t n) { resize(n); }
+    explicit BasicAoSoA(const allocator_type& a) : blocks(a) {}
+    BasicAoSoA(size_t n, const allocator_type& a) : blocks(a) { resize(n); }
+
+    allocator_type get_allocator() const { return blocks.get_allocator(); }
 
     size_t size() const       { return size_; }
     size_t num_blocks() const { return blocks.size(); }
@@ -63,7 +1269,36 @@ public:
         blocks.reserve((n + B - 1) / B);
     }
 
-    template<typename... Args>
+    // resize() with NUMA-aware first touch. The store is grown one block
+    // range at a time, in the ranges for_each_par / reduce_par with the same
+    // nthreads will hand out, each by the pool thread that owns it: that
+    // thread's value-initialization of its live blocks is their first
+    // touch, so with WorkerPool::set_affinity every thread later streams
+    // memory on its own node. The ranges grow in turn rather than at once
+    // (the store is not thread-safe), so this costs what resize() does.
+    // Pages only get placed on first touch: use it on fresh storage (a new
+    // container, or with HugePageAllocator, whose large blocks come
+    // straight from mmap); blocks a reallocation copies over are placed by
+    // the calling thread.
+    void resize_par(size_t n, size_t nthreads = WorkerPool::default_threads()) {
+        const size_t needed = (n + B - 1) / B;
+        if (needed > blocks.size()) {
+            blocks.reserve(needed);   // the one reallocation, before any range grows
+            const size_t tail = n % B;
+            const size_t full = (tail == 0) ? needed : needed - 1;
+            const size_t nt = std::clamp<size_t>(nthreads, 1, needed);
+            std::atomic<size_t> turn{0};
+            WorkerPool::global().run(nt, [&](size_t t) {
+                const size_t last = (t == nt - 1) ? needed : block_range(t, nt, full).second;
+                while (turn.load(std::memory_order_acquire) != t) std::this_thread::yield();
+                if (last > blocks.size()) blocks.resize(last);
+                turn.store(t + 1, std::memory_order_release);
+            });
+        }
+        resize(n);
+    }
+
+    template<typename... Args>
     void push_back(Args&&... args) {
         const size_t off = size_ % B;
         if (off == 0) blocks.emplace_back();
@@ -73,6 +1308,140 @@ public:
         ++size_;
     }
 
+    // Bulk append. Each entry point tops up a partially filled last block
+    // first, then fills whole blocks with one copy per field (memcpy for
+    // trivially copyable fields): a few large copies and one resize of the
+    // block store instead of a push_back, and a block check, per element.
+
+    // count elements from one pointer per field, e.g. an SOA's arrays.
+    void append_range(const Ts*... first, size_t count) {
+        if (count == 0) return;
+        append_fields(std::tuple<const Ts*...>{first...}, count, std::index_sequence_for<Ts...>{});
+    }
+
+    // Every element of other (not *this), which may use any allocator or
+    // block store. When this container ends on a block boundary the blocks
+    // are copied whole; otherwise each source block is split across two
+    // output blocks.
+    template<class A2>
+    void append(const BasicAoSoA<B, A2, Ts...>& other) {
+        const size_t nb = other.blocks.size();
+        if (nb == 0) return;
+        if (size_ % B == 0) {
+            const size_t base = blocks.size();
+            blocks.resize(base + nb);
+            for (size_t bi = 0; bi < nb; ++bi) blocks[base + bi] = other.blocks[bi];
+            size_ += other.size_;
+            return;
+        }
+        const size_t total = size_ + other.size_;
+        blocks.resize((total + B - 1) / B);
+        const size_t tail = other.size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        for (size_t bi = 0; bi < full; ++bi) write_block(size_ + bi * B, other.blocks[bi], B);
+        if (tail > 0) write_block(size_ + full * B, other.blocks[full], tail);
+        size_ = total;
+    }
+
+    // nblocks full blocks (B elements each) starting at first.
+    void append_blocks(const BlockT* first, size_t nblocks) {
+        if (size_ % B == 0) {
+            const size_t base = blocks.size();
+            blocks.resize(base + nblocks);
+            for (size_t bi = 0; bi < nblocks; ++bi) blocks[base + bi] = first[bi];
+            size_ += nblocks * B;
+            return;
+        }
+        const size_t total = size_ + nblocks * B;
+        blocks.resize((total + B - 1) / B);
+        for (size_t bi = 0; bi < nblocks; ++bi) write_block(size_ + bi * B, first[bi], B);
+        size_ = total;
+    }
+
+    // Concurrent append: several producer threads filling one AoSoA with no
+    // lock. The constructor sizes the block store for `capacity` more
+    // elements up front, so nothing is allocated or moved while producers
+    // run (with SegmentedStorage that only adds pages). A producer claims a
+    // slot range with one fetch_add on the shared cursor, writes it with
+    // plain stores, and commits it. publish(), called by the owner once the
+    // producers are done, waits until every claimed slot is committed, then
+    // grows size() and trims the spare blocks: no reader sees an element
+    // before it is fully written. publish() ends the session.
+    //
+    // A claim that runs past the reserved capacity is truncated, so
+    // Slots::count may be smaller than asked for, or zero. Claiming whole
+    // multiples of B keeps producers out of each other's blocks. The target
+    // container must not be touched between construction and publish().
+    class ConcurrentAppender {
+    public:
+        struct Slots { size_t first; size_t count; };
+
+        ConcurrentAppender(BasicAoSoA& target, size_t capacity)
+            : target_(target), base_(target.size_), limit_(target.size_ + capacity),
+              next_(target.size_), committed_(target.size_) {
+            target_.blocks.resize((limit_ + B - 1) / B);
+        }
+
+        ConcurrentAppender(const ConcurrentAppender&) = delete;
+        ConcurrentAppender& operator=(const ConcurrentAppender&) = delete;
+
+        Slots claim(size_t n) {
+            const size_t first = next_.fetch_add(n, std::memory_order_relaxed);
+            if (first >= limit_) return {limit_, 0};
+            return {first, std::min(n, limit_ - first)};
+        }
+
+        // Element i must lie in a range this thread claimed.
+        template<typename... Args>
+        void write(size_t i, Args&&... args) {
+            write_at(target_.blocks[i / B], i % B,
+                     std::forward_as_tuple(std::forward<Args>(args)...),
+                     std::index_sequence_for<Ts...>{});
+        }
+
+        void write_range(size_t first, const Ts*... src, size_t count) {
+            target_.write_fields(first, std::tuple<const Ts*...>{src...}, count,
+                                 std::index_sequence_for<Ts...>{});
+        }
+
+        void commit(size_t n) { committed_.fetch_add(n, std::memory_order_release); }
+
+        // claim + write + commit for one element; false when full.
+        template<typename... Args>
+        bool push_back(Args&&... args) {
+            const Slots s = claim(1);
+            if (s.count == 0) return false;
+            write(s.first, std::forward<Args>(args)...);
+            commit(1);
+            return true;
+        }
+
+        // claim + write_range + commit; returns how many elements fit.
+        size_t append_range(const Ts*... src, size_t count) {
+            const Slots s = claim(count);
+            if (s.count == 0) return 0;
+            write_range(s.first, src..., s.count);
+            commit(s.count);
+            return s.count;
+        }
+
+        // Returns the number of elements appended in this session.
+        size_t publish() {
+            const size_t end = std::min(next_.load(std::memory_order_relaxed), limit_);
+            while (committed_.load(std::memory_order_acquire) < end) std::this_thread::yield();
+            target_.size_ = end;
+            target_.blocks.resize((end + B - 1) / B);
+            return end - base_;
+        }
+
+    private:
+        BasicAoSoA& target_;
+        const size_t base_;
+        const size_t limit_;
+        alignas(64) std::atomic<size_t> next_;
+        alignas(64) std::atomic<size_t> committed_;
+    };
+
     // ========================================================================
     // Primary API: functional, lambda-driven.
     //
@@ -84,11 +1453,11 @@ public:
     // Apply f(refs...) to every element.
     template<class F>
     void for_each(F&& f) {
-        for_each_impl(std::forward<F>(f), std::index_sequence_for<Ts...>{});
+        for_each_policy_impl<policy::Exec<>>(*this, f, std::index_sequence_for<Ts...>{});
     }
     template<class F>
     void for_each(F&& f) const {
-        for_each_const_impl(std::forward<F>(f), std::index_sequence_for<Ts...>{});
+        for_each_policy_impl<policy::Exec<>>(*this, f, std::index_sequence_for<Ts...>{});
     }
 
     // Unrolled variant: processes UNROLL blocks per outer iteration. The
@@ -107,13 +1476,11 @@ public:
     // B=16. Leave the default for_each for everything else.
     template<size_t UNROLL, class F>
     void for_each_unrolled(F&& f) {
-        for_each_unrolled_impl<UNROLL>(std::forward<F>(f),
-                                       std::index_sequence_for<Ts...>{});
+        for_each(policy::unroll<UNROLL>, f);
     }
     template<size_t UNROLL, class F>
     void for_each_unrolled(F&& f) const {
-        for_each_unrolled_const_impl<UNROLL>(std::forward<F>(f),
-                                             std::index_sequence_for<Ts...>{});
+        for_each(policy::unroll<UNROLL>, f);
     }
 
     // Multi-stream variant: splits the block vector into K far-apart segments
@@ -127,13 +1494,94 @@ public:
     // hardware). Neutral in cache. Intended as opt-in for large-N reductions.
     template<size_t K, class F>
     void for_each_multistream(F&& f) {
-        for_each_multistream_impl<K>(std::forward<F>(f),
-                                     std::index_sequence_for<Ts...>{});
+        for_each(policy::streams<K>, f);
     }
     template<size_t K, class F>
     void for_each_multistream(F&& f) const {
-        for_each_multistream_const_impl<K>(std::forward<F>(f),
-                                           std::index_sequence_for<Ts...>{});
+        for_each(policy::streams<K>, f);
+    }
+
+    // for_each under an execution policy (policy::unroll / streams /
+    // prefetch, composed with |), over all fields or over fields<Is...>.
+    // for_each, for_each_unrolled, for_each_multistream and for_each_field
+    // are the single-knob cases of these.
+    template<class P, class F> requires policy::is_exec_v<P>
+    void for_each(P, F&& f) {
+        for_each_policy_impl<P>(*this, f, std::index_sequence_for<Ts...>{});
+    }
+    template<class P, class F> requires policy::is_exec_v<P>
+    void for_each(P, F&& f) const {
+        for_each_policy_impl<P>(*this, f, std::index_sequence_for<Ts...>{});
+    }
+    template<class P, size_t... Sel, class F> requires policy::is_exec_v<P>
+    void for_each(P, FieldSelect<Sel...>, F&& f) {
+        static_assert(sizeof...(Sel) > 0, "fields<> needs at least one field");
+        for_each_policy_impl<P>(*this, f, std::index_sequence<Sel...>{});
+    }
+    template<class P, size_t... Sel, class F> requires policy::is_exec_v<P>
+    void for_each(P, FieldSelect<Sel...>, F&& f) const {
+        static_assert(sizeof...(Sel) > 0, "fields<> needs at least one field");
+        for_each_policy_impl<P>(*this, f, std::index_sequence<Sel...>{});
+    }
+
+    // for_each with the traversal picked by an Autotuner: for_each,
+    // for_each_unrolled<2/4/8> or for_each_multistream<4/8/16>, whichever
+    // timed fastest for (op, this type, this size class). op names the
+    // kernel, since a lambda's type does not survive a rebuild; it must be
+    // one token, and std::invalid_argument is thrown otherwise. Every call
+    // applies f once per element, calibrating or not, so this is a drop-in
+    // for for_each; once the choice is made, the tuner lookup is a scan of a
+    // short per-thread cache, without lock or allocation. Call
+    // it from one place per kernel: with two call sites GCC outlines the
+    // strategy bodies and a by-reference accumulator in f stays in memory.
+    template<class F>
+    void for_each_auto(std::string_view op, F&& f, Autotuner& tuner = Autotuner::global()) {
+        if (size_ == 0) return;
+        const size_t bytes = blocks.size() * sizeof(BlockT);
+        const auto pick = tuner.next(op, type_config(), bytes);
+        // One dispatch site, so it inlines into the caller together with f.
+        const auto t0 = pick.timed ? std::chrono::steady_clock::now()
+                                   : std::chrono::steady_clock::time_point{};
+        for_each_strategy(pick.strategy, f);
+        if (!pick.timed) return;
+        const std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+        tuner.record(op, type_config(), bytes, pick.strategy, dt.count() / double(size_));
+    }
+
+    // The strategy for_each_auto(op) has settled on at the current size,
+    // once calibration for that size class is over.
+    std::optional<Autotuner::Strategy> auto_strategy(std::string_view op,
+                                                     Autotuner& tuner = Autotuner::global()) const {
+        return tuner.chosen(op, type_config(), blocks.size() * sizeof(BlockT));
+    }
+
+    // "B<B>:<T0>,<T1>,...@<Alloc>" with typeid names: the type part of a
+    // tuner key. Alloc is in it because it picks the block store: a paged
+    // SegmentedAoSoA and a contiguous AoSoA of the same fields tune apart.
+    static const std::string& type_config() {
+        static const std::string config = [] {
+            std::string c = "B" + std::to_string(B) + ":";
+            ((c += typeid(Ts).name(), c += ','), ...);
+            c.back() = '@';
+            c += typeid(Alloc).name();
+            return c;
+        }();
+        return config;
+    }
+
+    // Runs one strategy by name: what for_each_auto dispatches to.
+    template<class F>
+    void for_each_strategy(Autotuner::Strategy s, F&& f) {
+        using S = Autotuner::Strategy;
+        switch (s) {
+        case S::unroll2:  for_each_unrolled<2>(f);    break;
+        case S::unroll4:  for_each_unrolled<4>(f);    break;
+        case S::unroll8:  for_each_unrolled<8>(f);    break;
+        case S::stream4:  for_each_multistream<4>(f); break;
+        case S::stream8:  for_each_multistream<8>(f); break;
+        case S::stream16: for_each_multistream<16>(f); break;
+        default:          for_each(f);                break;
+        }
     }
 
     // Apply f(global_index, refs...) to every element. Useful when the body
@@ -148,24 +1596,244 @@ public:
     template<size_t... Sel, class F>
     void for_each_field(F&& f) {
         static_assert(sizeof...(Sel) > 0, "for_each_field needs at least one field");
-        for_each_field_impl<Sel...>(std::forward<F>(f));
+        for_each_policy_impl<policy::Exec<>>(*this, f, std::index_sequence<Sel...>{});
+    }
+
+    // Parallel variants of for_each / for_each_field. The full blocks are
+    // split into nthreads contiguous block ranges (a Block is never shared
+    // between two threads, so there is no false sharing on the data) and run
+    // on WorkerPool::global(); the partial tail block goes to the last range.
+    // f is called concurrently from several threads and must only touch the
+    // element it is handed.
+    template<class F>
+    void for_each_par(F&& f, size_t nthreads = WorkerPool::default_threads()) {
+        for_each_par_impl(f, nthreads, std::index_sequence_for<Ts...>{});
+    }
+    template<class F>
+    void for_each_par(F&& f, size_t nthreads = WorkerPool::default_threads()) const {
+        for_each_par_impl(f, nthreads, std::index_sequence_for<Ts...>{});
+    }
+
+    template<size_t... Sel, class F>
+    void for_each_field_par(F&& f, size_t nthreads = WorkerPool::default_threads()) {
+        static_assert(sizeof...(Sel) > 0, "for_each_field_par needs at least one field");
+        for_each_par_impl(f, nthreads, std::index_sequence<Sel...>{});
+    }
+
+    // Contiguous range [first, last) of the `full` complete blocks owned by
+    // thread t out of nthreads. Ranges differ in length by at most one block.
+    static std::pair<size_t, size_t> block_range(size_t t, size_t nthreads, size_t full) {
+        const size_t q = full / nthreads;
+        const size_t r = full % nthreads;
+        const size_t first = t * q + std::min(t, r);
+        return { first, first + q + (t < r ? 1 : 0) };
     }
 
     // Reduce: lambda takes (accumulator, refs...) and returns new accumulator.
     template<class Acc, class F>
     Acc reduce(Acc init, F&& f) const {
-        return reduce_impl(std::move(init), std::forward<F>(f),
-                           std::index_sequence_for<Ts...>{});
+        return reduce_policy_impl<policy::Exec<>>(std::move(init), f,
+                                                  std::index_sequence_for<Ts...>{});
+    }
+
+    // reduce under an execution policy, over all fields or fields<Is...>.
+    // The one accumulator is threaded through the blocks in traversal
+    // order, so with streams<K> a floating-point result can differ from the
+    // serial reduce in the last bits.
+    template<class P, class Acc, class F> requires policy::is_exec_v<P>
+    Acc reduce(P, Acc init, F&& f) const {
+        return reduce_policy_impl<P>(std::move(init), f, std::index_sequence_for<Ts...>{});
+    }
+    template<class P, size_t... Sel, class Acc, class F> requires policy::is_exec_v<P>
+    Acc reduce(P, FieldSelect<Sel...>, Acc init, F&& f) const {
+        static_assert(sizeof...(Sel) > 0, "fields<> needs at least one field");
+        return reduce_policy_impl<P>(std::move(init), f, std::index_sequence<Sel...>{});
+    }
+
+    // Parallel reduce. Each thread folds its block range into a private,
+    // cache-line-padded accumulator seeded with `init` — so init must be an
+    // identity of combine (0 for a sum) — and the partials are then merged
+    // pairwise in a fixed tree order, ((p0 + p1) + (p2 + p3)) + ... The
+    // result is therefore bit-reproducible for a given thread count, though
+    // not necessarily equal to the serial reduce for floating point.
+    template<class Acc, class F, class C>
+    Acc reduce_par(Acc init, F&& f, C&& combine,
+                   size_t nthreads = WorkerPool::default_threads()) const {
+        return reduce_par_impl(std::move(init), f, combine, nthreads,
+                               std::index_sequence_for<Ts...>{});
     }
 
     // Filter: returns a new AoSoA of the same shape containing elements
     // where pred(refs...) is true. Two-phase per block — predicate fills
     // a bool mask (vectorizes), then scalar compaction copies survivors.
+    // The output uses this container's allocator unless out_alloc is given
+    // (e.g. a FrameArena-backed polymorphic_allocator for a temporary).
+    template<class Pred>
+    BasicAoSoA filter(Pred&& pred) const {
+        return filter(std::forward<Pred>(pred), get_allocator());
+    }
+    template<class Pred>
+    BasicAoSoA filter(Pred&& pred, const allocator_type& out_alloc) const {
+        return filter_policy_impl<policy::Exec<>>(pred, out_alloc,
+                                                  std::index_sequence_for<Ts...>{});
+    }
+
+    // filter under an execution policy. With fields<Is...> pred sees only
+    // those fields; survivors are still copied whole. filter keeps element
+    // order, so it takes unroll and prefetch but not streams.
+    template<class P, class Pred> requires policy::is_exec_v<P>
+    BasicAoSoA filter(P, Pred&& pred) const {
+        return filter_policy_impl<P>(pred, get_allocator(), std::index_sequence_for<Ts...>{});
+    }
+    template<class P, size_t... Sel, class Pred> requires policy::is_exec_v<P>
+    BasicAoSoA filter(P, FieldSelect<Sel...>, Pred&& pred) const {
+        static_assert(sizeof...(Sel) > 0, "fields<> needs at least one field");
+        return filter_policy_impl<P>(pred, get_allocator(), std::index_sequence<Sel...>{});
+    }
+
+    // Filter into an existing container, replacing its contents and reusing
+    // its blocks: a frame's `alive` kept from one frame to the next needs no
+    // allocation or zeroing once it has reached size. With streaming stores
+    // (StoreMode; automatic decides from this container's size, the upper
+    // bound of the output) survivors are compacted into an L1 staging block
+    // and each full block is written out non-temporally. That only pays off
+    // because the blocks already exist and are out of cache: the stores
+    // neither read them in nor evict the input. `out` must not be *this.
+    template<class Pred>
+    void filter(Pred&& pred, BasicAoSoA& out, StoreMode mode = StoreMode::automatic) const {
+        filter_into_impl(pred, out, mode, std::index_sequence_for<Ts...>{});
+    }
+
+    // Transform: out[i] = f(refs...) for every element, into caller-owned
+    // storage of size() Rs (e.g. a std::vector<R>'s data()). With streaming
+    // stores (StoreMode; automatic decides from size() * sizeof(R)) results
+    // are staged 4 KiB at a time in an L1 buffer and written out
+    // non-temporally, followed by one fence.
+    template<class R, class F>
+    void transform(F&& f, R* out, StoreMode mode = StoreMode::automatic) const {
+        static_assert(std::is_trivially_copyable_v<R>, "transform output must be trivially copyable");
+        transform_impl(f, out, mode, std::index_sequence_for<Ts...>{});
+    }
+
+    // In-place cull: removes every element for which pred(refs...) is true.
+    // Survivors are compacted toward the front block by block, keeping their
+    // order, then size() shrinks; block storage is kept, so a per-frame cull
+    // does no allocation and no copy into a second container. Returns the
+    // number of elements removed.
+    template<class Pred>
+    size_t erase_if(Pred&& pred) {
+        return erase_if_impl(pred, std::index_sequence_for<Ts...>{});
+    }
+
+    // Unstable in-place cull: each removed element is overwritten by the
+    // current last element (which is then tested in turn), so only the
+    // removed slots are written. Use when element order does not matter.
+    template<class Pred>
+    size_t erase_if_unordered(Pred&& pred) {
+        return erase_if_unordered_impl(pred, std::index_sequence_for<Ts...>{});
+    }
+
+    // Parallel filter, two passes over the same block ranges: every thread
+    // counts its survivors, an exclusive scan of the counts gives each
+    // thread its output offset, and every thread then writes its survivors
+    // straight into the pre-sized output — no push_back, original order kept.
+    // pred is evaluated twice per element and must be a pure function of it.
+    template<class Pred>
+    BasicAoSoA filter_par(Pred&& pred, size_t nthreads = WorkerPool::default_threads()) const {
+        return filter_par_impl(pred, get_allocator(), nthreads, std::index_sequence_for<Ts...>{});
+    }
     template<class Pred>
-    AoSoA filter(Pred&& pred) const {
-        return filter_impl(std::forward<Pred>(pred),
-                           std::index_sequence_for<Ts...>{});
+    BasicAoSoA filter_par(Pred&& pred, const allocator_type& out_alloc,
+                          size_t nthreads = WorkerPool::default_threads()) const {
+        return filter_par_impl(pred, out_alloc, nthreads, std::index_sequence_for<Ts...>{});
+    }
+
+    // Fused frame: for_each(update), then reduce(init, f), then
+    // filter(keep) into `out`, run as one sweep instead of three. The
+    // blocks are cut into chunks of about half an L2 (chunk_bytes), which
+    // pool threads claim in order; each chunk goes through all three stages
+    // while it is still cache-resident, so DRAM sees the data once.
+    //
+    // Each chunk folds into its own accumulator and the partials are merged
+    // in a fixed tree order over chunks, so the result does not depend on
+    // nthreads or on which thread ran which chunk; init must be an identity
+    // of combine, as for reduce_par. Survivors land in `out` in source
+    // order: a chunk counts its survivors, waits for the previous chunk's
+    // output end (already known by the time it has counted, in the common
+    // case), publishes its own, then writes. `out` is resized to size()
+    // up front and trimmed at the end, so reusing one `out` across frames
+    // keeps its storage allocated and warm. `out` must not be *this; keep
+    // and f see each element after update, and keep is called once per
+    // element (its verdicts are kept for the scatter), so it need not be pure.
+    template<class U, class Acc, class F, class C, class Pred>
+    Acc update_reduce_filter_par(U&& update, Acc init, F&& f, C&& combine, Pred&& keep,
+                                 BasicAoSoA& out,
+                                 size_t nthreads = WorkerPool::default_threads(),
+                                 size_t chunk_bytes = aosoa_detail::l2_cache_bytes() / 2) {
+        return update_reduce_filter_par_impl(update, std::move(init), f, combine, keep, out,
+                                             nthreads, chunk_bytes,
+                                             std::index_sequence_for<Ts...>{});
+    }
+
+#if AOSOA_HAS_STDX_SIMD
+    // ========================================================================
+    // Explicit-SIMD traversal: the lambda gets one pack per field.
+    //
+    // Every pack has simd_width lanes: the narrowest native width among the
+    // field types (capped at B), so an int/float/double config runs 4 lanes
+    // per field on AVX2 and the float pack stays in an xmm. Packs are loaded
+    // aligned straight from the Block whenever every field array starts on
+    // a pack-alignment boundary, which the alignas(64) Block guarantees for
+    // the usual power-of-two B; other shapes fall back to unaligned loads.
+    //
+    // A block whose valid count is not a multiple of simd_width ends with a
+    // masked pack: inactive lanes are zero on entry and are never stored.
+    // Because the body is written against packs, branches become where()
+    // blends and accumulators stay vectors, so kernels vectorize that the
+    // scalar for_each leaves serial (dependency chains, ternaries, calls).
+    // ========================================================================
+    static constexpr bool is_simd_vectorizable =
+        std::conjunction_v<std::bool_constant<std::is_arithmetic_v<Ts> &&
+                                              !std::is_same_v<Ts, bool>>...>;
+
+    static constexpr size_t simd_width = [] {
+        if constexpr (is_simd_vectorizable) {
+            return std::min({ aosoa_detail::stdx::native_simd<Ts>::size()..., std::bit_floor(B) });
+        } else {
+            return size_t{1};
+        }
+    }();
+
+    template<class T>
+    using simd_t = aosoa_detail::stdx::simd<
+        T, aosoa_detail::stdx::simd_abi::deduce_t<T, simd_width>>;
+
+    // Apply f(packs...) to every simd_width-element chunk; packs are written
+    // back after the call.
+    template<class F>
+    void for_each_simd(F&& f)
+        requires (is_simd_vectorizable)
+    {
+        for_each_simd_impl(f, std::index_sequence_for<Ts...>{});
+    }
+    template<class F>
+    void for_each_simd(F&& f) const
+        requires (is_simd_vectorizable)
+    {
+        for_each_simd_impl(f, std::index_sequence_for<Ts...>{});
+    }
+
+    // Reduce over packs: f(acc, packs...) returns the new acc, a simd_t<R>.
+    // On a masked chunk the inactive lanes of acc keep their previous value,
+    // so any lane-wise fold is exact; finish with stdx::reduce(acc).
+    template<class Acc, class F>
+    Acc reduce_simd(Acc acc, F&& f) const
+        requires (is_simd_vectorizable)
+    {
+        static_assert(Acc::size() == simd_width, "reduce_simd accumulator must have simd_width lanes");
+        return reduce_simd_impl(std::move(acc), f, std::index_sequence_for<Ts...>{});
     }
+#endif // AOSOA_HAS_STDX_SIMD
 
     // ========================================================================
     // Opt-in SIMD fast path for float-only, B=16 AoSoA.
@@ -194,8 +1862,9 @@ public:
         (B == 16) && (sizeof...(Ts) >= 1) &&
         (std::conjunction_v<std::is_same<Ts, float>...>);
 
-#if AOSOA_HAS_AVX2
+#if AOSOA_HAS_AVX2 || AOSOA_HAS_X86_DISPATCH
     // Sum all fields of all elements with 8 per-field __m256 accumulators.
+    AOSOA_TARGET_AVX2
     float sum_all_f32_avx2() const
         requires (is_float_only_B16)
     {
@@ -218,15 +1887,7 @@ public:
                 // pressure (confirmed), but at 1M DRAM-bound it blows the
                 // timing from 1.3x to 3.0x vs SOA because only 1 of 8 lines
                 // arrives ahead of time. Keeping all 8 for the DRAM win.
-                const char* next = reinterpret_cast<const char*>(&blocks[bi + PF_AHEAD]);
-                _mm_prefetch(next,        _MM_HINT_T0);
-                _mm_prefetch(next + 64,   _MM_HINT_T0);
-                _mm_prefetch(next + 128,  _MM_HINT_T0);
-                _mm_prefetch(next + 192,  _MM_HINT_T0);
-                _mm_prefetch(next + 256,  _MM_HINT_T0);
-                _mm_prefetch(next + 320,  _MM_HINT_T0);
-                _mm_prefetch(next + 384,  _MM_HINT_T0);
-                _mm_prefetch(next + 448,  _MM_HINT_T0);
+                prefetch_block_impl(&blocks[bi + PF_AHEAD]);
             }
             const auto& blk = blocks[bi];
             sum_block_avx2_impl<0>(blk, acc);
@@ -241,9 +1902,79 @@ public:
         }
         return out;
     }
+#endif
+
+#if AOSOA_HAS_AVX2
+    // sum_all_f32_avx2 with the lookahead moved to a helper thread. At DRAM
+    // sizes the in-loop prefetches above are limited by the core's own
+    // miss buffers; a helper on the SMT sibling shares L1/L2 but brings its
+    // own. It runs as thread 1 of a two-thread WorkerPool run and loads one
+    // word per cache line of each block, staying at most `ahead` blocks in
+    // front of the compute thread (thread 0, no prefetches of its own),
+    // which publishes its position every block. Pin the pool first, e.g.
+    // WorkerPool::global().set_affinity(WorkerPool::smt_siblings(cpu)):
+    // unpinned, or on a machine without SMT, the helper only competes for
+    // a core. With a single CPU there is nowhere to run it and this falls
+    // back to sum_all_f32_avx2. Same result as sum_all_f32_avx2.
+    float sum_all_f32_avx2_helper(size_t ahead = 32) const
+        requires (is_float_only_B16)
+    {
+        if (WorkerPool::default_threads() < 2) return sum_all_f32_avx2();
+        const size_t nb = blocks.size();
+        if (nb == 0) return 0.0f;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        constexpr size_t done_flag = ~size_t{0};
+        alignas(64) std::atomic<size_t> pos{0};
+
+        constexpr size_t N = sizeof...(Ts);
+        __m256 acc[N];
+
+        WorkerPool::global().run(2, [&](size_t t) {
+            if (t == 0) {
+                // Local accumulators, so they stay in registers across the
+                // position stores.
+                __m256 a[N];
+                for (size_t f = 0; f < N; ++f) a[f] = _mm256_setzero_ps();
+                for (size_t bi = 0; bi < full; ++bi) {
+                    pos.store(bi, std::memory_order_relaxed);
+                    sum_block_avx2_impl<0>(blocks[bi], a);
+                }
+                pos.store(done_flag, std::memory_order_relaxed);
+                for (size_t f = 0; f < N; ++f) acc[f] = a[f];
+                return;
+            }
+            size_t pf = 0;
+            for (;;) {
+                const size_t at = pos.load(std::memory_order_relaxed);
+                if (at == done_flag) return;
+                pf = std::max(pf, at + 1);
+                const size_t lim = std::min(full, at + 1 + ahead);
+                if (pf >= lim) {
+                    if (pf >= full) return;
+                    _mm_pause();
+                    continue;
+                }
+                for (; pf < lim; ++pf) touch_block_impl(&blocks[pf]);
+            }
+        });
+
+        __m256 total = _mm256_setzero_ps();
+        for (size_t f = 0; f < N; ++f) total = _mm256_add_ps(total, acc[f]);
+        float out = hsum256_ps(total);
+
+        if (tail > 0) {
+            const auto& blk = blocks[full];
+            sum_scalar_tail_impl<0>(blk, tail, out);
+        }
+        return out;
+    }
+#endif
 
+#if AOSOA_HAS_AVX2 || AOSOA_HAS_X86_DISPATCH
     // Compute x0*x1 + x2 + x3 + ... + x(N-1), summed over all elements.
     // FMA on the multiplied pair, per-field accumulators on the added rest.
+    AOSOA_TARGET_AVX2
     float compute_all_f32_avx2() const
         requires (is_float_only_B16 && sizeof...(Ts) >= 3)
     {
@@ -268,15 +1999,7 @@ public:
                 // pressure (confirmed), but at 1M DRAM-bound it blows the
                 // timing from 1.3x to 3.0x vs SOA because only 1 of 8 lines
                 // arrives ahead of time. Keeping all 8 for the DRAM win.
-                const char* next = reinterpret_cast<const char*>(&blocks[bi + PF_AHEAD]);
-                _mm_prefetch(next,        _MM_HINT_T0);
-                _mm_prefetch(next + 64,   _MM_HINT_T0);
-                _mm_prefetch(next + 128,  _MM_HINT_T0);
-                _mm_prefetch(next + 192,  _MM_HINT_T0);
-                _mm_prefetch(next + 256,  _MM_HINT_T0);
-                _mm_prefetch(next + 320,  _MM_HINT_T0);
-                _mm_prefetch(next + 384,  _MM_HINT_T0);
-                _mm_prefetch(next + 448,  _MM_HINT_T0);
+                prefetch_block_impl(&blocks[bi + PF_AHEAD]);
             }
             const auto& blk = blocks[bi];
             __m256 x0a, x0b, x1a, x1b;
@@ -296,8 +2019,257 @@ public:
         }
         return out;
     }
+#endif
+
+#if AOSOA_HAS_AVX2
+#if AOSOA_HAS_AVX512
+    // AVX-512F versions of the two reductions above. On B=16 a float field
+    // array is exactly one zmm and one cache line, so every field costs one
+    // aligned load and one add per block instead of two of each. The tail
+    // block goes through the same per-field accumulators with a masked
+    // zero-filling load, so there is no scalar epilogue.
+    float sum_all_f32_avx512() const
+        requires (is_float_only_B16)
+    {
+        const size_t nb = blocks.size();
+        if (nb == 0) return 0.0f;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        constexpr size_t N = sizeof...(Ts);
+        __m512 acc[N];
+        for (size_t f = 0; f < N; ++f) acc[f] = _mm512_setzero_ps();
+
+        constexpr size_t PF_AHEAD = 8;
+        for (size_t bi = 0; bi < full; ++bi) {
+            if (bi + PF_AHEAD < full) prefetch_block_impl(&blocks[bi + PF_AHEAD]);
+            sum_block_avx512_impl<0>(blocks[bi], static_cast<__mmask16>(0xFFFF), acc);
+        }
+        if (tail > 0) {
+            sum_block_avx512_impl<0>(blocks[full], static_cast<__mmask16>((1u << tail) - 1), acc);
+        }
+        __m512 total = _mm512_setzero_ps();
+        for (size_t f = 0; f < N; ++f) total = _mm512_add_ps(total, acc[f]);
+        return _mm512_reduce_add_ps(total);
+    }
+
+    // Compute x0*x1 + x2 + x3 + ... + x(N-1), summed over all elements.
+    float compute_all_f32_avx512() const
+        requires (is_float_only_B16 && sizeof...(Ts) >= 3)
+    {
+        const size_t nb = blocks.size();
+        if (nb == 0) return 0.0f;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        constexpr size_t N = sizeof...(Ts);
+        __m512 acc_mul = _mm512_setzero_ps();
+        __m512 acc_sum[N];
+        for (size_t f = 0; f < N; ++f) acc_sum[f] = _mm512_setzero_ps();
+
+        auto run = [&](const BlockT& blk, __mmask16 m) {
+            const __m512 x0 = _mm512_maskz_load_ps(m, std::get<0>(blk.data).data());
+            const __m512 x1 = _mm512_maskz_load_ps(m, std::get<1>(blk.data).data());
+            acc_mul = _mm512_fmadd_ps(x0, x1, acc_mul);
+            sum_block_avx512_impl<2>(blk, m, acc_sum);
+        };
+
+        constexpr size_t PF_AHEAD = 8;
+        for (size_t bi = 0; bi < full; ++bi) {
+            if (bi + PF_AHEAD < full) prefetch_block_impl(&blocks[bi + PF_AHEAD]);
+            run(blocks[bi], static_cast<__mmask16>(0xFFFF));
+        }
+        if (tail > 0) run(blocks[full], static_cast<__mmask16>((1u << tail) - 1));
+
+        __m512 total = acc_mul;
+        for (size_t f = 2; f < N; ++f) total = _mm512_add_ps(total, acc_sum[f]);
+        return _mm512_reduce_add_ps(total);
+    }
+#endif // AOSOA_HAS_AVX512
+
+    // Widest compiled-in version of the two reductions: AVX-512 when the
+    // build targets it, AVX2 otherwise.
+    float sum_all_f32() const
+        requires (is_float_only_B16)
+    {
+#if AOSOA_HAS_AVX512
+        return sum_all_f32_avx512();
+#else
+        return sum_all_f32_avx2();
+#endif
+    }
+
+    float compute_all_f32() const
+        requires (is_float_only_B16 && sizeof...(Ts) >= 3)
+    {
+#if AOSOA_HAS_AVX512
+        return compute_all_f32_avx512();
+#else
+        return compute_all_f32_avx2();
+#endif
+    }
+
+    // ========================================================================
+    // Generic AVX2 reductions for any int32/float/double config and any B.
+    //
+    // Same shape as sum_all_f32_avx2 / compute_all_f32_avx2 — one vector
+    // accumulator per field, a ~4 KiB software prefetch lookahead — but the
+    // vector type follows the result type R = common_type<Ts...>: __m256
+    // for float, __m256d for double, __m256i for int. Narrower fields are
+    // widened on load (an int/float/double config accumulates in __m256d).
+    // Each field array is walked as B / lanes vectors; when B is not a
+    // multiple of lanes (e.g. B=2, 4 for float) the leftover elements of
+    // each block fall back to a scalar fold.
+    // ========================================================================
+    using reduce_t = std::common_type_t<Ts...>;
+
+    static constexpr bool is_avx2_reducible =
+        (std::is_same_v<reduce_t, float> || std::is_same_v<reduce_t, double> ||
+         std::is_same_v<reduce_t, int32_t>) &&
+        (aosoa_detail::widens_to<reduce_t, Ts> && ...);
+
+    // Sum of all fields of all elements.
+    reduce_t sum_all_avx2() const
+        requires (is_avx2_reducible)
+    {
+        return sum_all_avx2_impl(std::index_sequence_for<Ts...>{});
+    }
+
+    // x0*x1 + x2 + ... + x(N-1), summed over all elements.
+    reduce_t compute_all_avx2() const
+        requires (is_avx2_reducible && sizeof...(Ts) >= 2)
+    {
+        return compute_all_avx2_impl(std::make_index_sequence<sizeof...(Ts) - 2>{});
+    }
+
+    // Filter with SIMD stream compaction. Phase 1 is filter's vectorizable
+    // bool mask; phase 2 turns each 8-element slice of the mask into a
+    // movemask byte and packs the surviving lanes of every field with one
+    // permute (AVX2 lookup table, or vcompress when AVX-512 is available),
+    // storing whole packed vectors into the output block instead of one
+    // element at a time. Lanes past the packed count are scratch and get
+    // overwritten by the next store, so they never become visible.
+    //
+    // Needs B % 8 == 0 and fields that are all 4- or 8-byte arithmetic types.
+    static constexpr bool is_compactable =
+        (B % 8 == 0) &&
+        (std::conjunction_v<std::bool_constant<std::is_arithmetic_v<Ts> &&
+                                               (sizeof(Ts) == 4 || sizeof(Ts) == 8)>...>);
+
+    template<class Pred>
+    BasicAoSoA filter_simd(Pred&& pred) const
+        requires (is_compactable)
+    {
+        return filter_simd_impl(pred, get_allocator(), std::index_sequence_for<Ts...>{});
+    }
+    template<class Pred>
+    BasicAoSoA filter_simd(Pred&& pred, const allocator_type& out_alloc) const
+        requires (is_compactable)
+    {
+        return filter_simd_impl(pred, out_alloc, std::index_sequence_for<Ts...>{});
+    }
 #endif // AOSOA_HAS_AVX2
 
+#if AOSOA_HAS_X86_DISPATCH
+    // ========================================================================
+    // Runtime-dispatched float-only B=16 reductions.
+    //
+    // Same results as sum_all_f32 / compute_all_f32, but the kernel is picked
+    // from the running CPU rather than the compiler flags: every variant is
+    // compiled with its own target attribute, cpu_isa() probes cpuid once,
+    // and the choice is cached in a static function pointer per AoSoA type.
+    // This is what lets one baseline binary (AOSOA_NATIVE=OFF) use AVX2 or
+    // AVX-512 where available. The cost over a direct call is one indirect
+    // call per reduction, not per element.
+    // ========================================================================
+    using f32_kernel_t = float (*)(const BasicAoSoA&);
+
+    float sum_all_f32_dispatch() const
+        requires (is_float_only_B16)
+    {
+        static const f32_kernel_t k = select_f32_kernel<false>();
+        return k(*this);
+    }
+
+    float compute_all_f32_dispatch() const
+        requires (is_float_only_B16 && sizeof...(Ts) >= 3)
+    {
+        static const f32_kernel_t k = select_f32_kernel<true>();
+        return k(*this);
+    }
+
+    // The per-ISA variants behind the dispatch, for callers (and benchmarks)
+    // that already know what the CPU supports. Compute selects
+    // x0*x1 + x2 + ... + x(N-1) instead of the plain sum.
+    template<bool Compute>
+    static float f32_kernel_scalar(const BasicAoSoA& a)
+        requires (is_float_only_B16)
+    {
+        return a.reduce(0.0f, [](float acc, float x0, auto... xs) {
+            if constexpr (Compute) {
+                return [&](float x1, auto... rest) {
+                    return acc + x0 * x1 + (0.0f + ... + rest);
+                }(xs...);
+            } else {
+                return acc + x0 + (0.0f + ... + xs);
+            }
+        });
+    }
+
+    template<bool Compute>
+    static float f32_kernel_avx2(const BasicAoSoA& a)
+        requires (is_float_only_B16)
+    {
+        if constexpr (Compute) return a.compute_all_f32_avx2();
+        else                   return a.sum_all_f32_avx2();
+    }
+
+    template<bool Compute>
+    __attribute__((target("avx512f")))
+    static float f32_kernel_avx512(const BasicAoSoA& a)
+        requires (is_float_only_B16)
+    {
+        constexpr size_t N = sizeof...(Ts);
+        const size_t nb = a.blocks.size();
+        if (nb == 0) return 0.0f;
+        const size_t tail = a.size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        const auto off = field_offsets(a.blocks[0]);
+
+        __m512 acc[N];
+        for (size_t f = 0; f < N; ++f) acc[f] = _mm512_setzero_ps();
+        for (size_t bi = 0; bi < nb; ++bi) {
+            if (bi + 8 < full) prefetch_block_impl(&a.blocks[bi + 8]);
+            const __mmask16 m = (bi < full) ? static_cast<__mmask16>(0xFFFF)
+                                            : static_cast<__mmask16>((1u << tail) - 1);
+            const char* base = reinterpret_cast<const char*>(&a.blocks[bi]);
+            size_t f = 0;
+            if constexpr (Compute) {
+                acc[0] = _mm512_fmadd_ps(
+                    _mm512_maskz_load_ps(m, reinterpret_cast<const float*>(base + off[0])),
+                    _mm512_maskz_load_ps(m, reinterpret_cast<const float*>(base + off[1])), acc[0]);
+                f = 2;
+            }
+            for (; f < N; ++f) {
+                acc[f] = _mm512_add_ps(acc[f],
+                    _mm512_maskz_load_ps(m, reinterpret_cast<const float*>(base + off[f])));
+            }
+        }
+        __m512 total = _mm512_setzero_ps();
+        for (size_t f = 0; f < N; ++f) total = _mm512_add_ps(total, acc[f]);
+        return _mm512_reduce_add_ps(total);
+    }
+
+    template<bool Compute>
+    static f32_kernel_t select_f32_kernel() {
+        switch (aosoa_detail::cpu_isa()) {
+        case aosoa_detail::Isa::avx512: return &f32_kernel_avx512<Compute>;
+        case aosoa_detail::Isa::avx2:   return &f32_kernel_avx2<Compute>;
+        default:                        return &f32_kernel_scalar<Compute>;
+        }
+    }
+#endif // AOSOA_HAS_X86_DISPATCH
+
     // ========================================================================
     // Escape hatch: raw block iteration.
     //
@@ -343,7 +2315,7 @@ public:
     };
 
     class Iterator {
-        AoSoA* owner_;
+        BasicAoSoA* owner_;
         size_t block_idx_;
         size_t offset_;
     public:
@@ -351,7 +2323,7 @@ public:
         using value_type        = Proxy;
         using difference_type   = std::ptrdiff_t;
 
-        Iterator(AoSoA* o, size_t flat)
+        Iterator(BasicAoSoA* o, size_t flat)
             : owner_(o), block_idx_(flat / B), offset_(flat % B) {}
 
         Proxy operator*() {
@@ -395,9 +2367,10 @@ public:
     }
 
 private:
-#if AOSOA_HAS_AVX2
+#if AOSOA_HAS_AVX2 || AOSOA_HAS_X86_DISPATCH
     // ---- SIMD intrinsic helpers for sum_all_f32_avx2 / compute_all_f32_avx2 ----
 
+    AOSOA_TARGET_AVX2
     static inline float hsum256_ps(__m256 v) {
         __m128 lo = _mm256_castps256_ps128(v);
         __m128 hi = _mm256_extractf128_ps(v, 1);
@@ -409,6 +2382,7 @@ private:
         return _mm_cvtss_f32(sums);
     }
 
+    AOSOA_TARGET_AVX2
     static inline void load_aligned_pair_impl(const float* ptr, __m256& a, __m256& b) {
         a = _mm256_load_ps(ptr);
         b = _mm256_load_ps(ptr + 8);
@@ -416,6 +2390,7 @@ private:
 
     // Recursive per-field fold: unrolled at compile time for all fields.
     template<size_t F>
+    AOSOA_TARGET_AVX2
     static inline void sum_block_avx2_impl(const BlockT& blk, __m256* acc) {
         if constexpr (F < sizeof...(Ts)) {
             __m256 a, b;
@@ -426,6 +2401,7 @@ private:
     }
 
     template<size_t F>
+    AOSOA_TARGET_AVX2
     static inline void compute_sum_rest_impl(const BlockT& blk, __m256* acc_sum) {
         if constexpr (F < sizeof...(Ts)) {
             __m256 a, b;
@@ -454,360 +2430,1527 @@ private:
             out += v;
         }
     }
-#endif // AOSOA_HAS_AVX2
 
-    // ---- for_each / reduce / filter internals ----
+    // Every cache line of a block (8 for a B=16 float8 block); see
+    // sum_all_f32_avx2 for why none of them can be left to the next-line
+    // prefetcher.
+    static inline void prefetch_block_impl(const BlockT* blk) {
+        const char* p = reinterpret_cast<const char*>(blk);
+        for (size_t off = 0; off < sizeof(BlockT); off += 64) {
+            _mm_prefetch(p + off, _MM_HINT_T0);
+        }
+    }
+#endif
 
-    template<class F, size_t... Is>
-    void for_each_impl(F&& f, std::index_sequence<Is...>) {
-        const size_t nb = blocks.size();
+#if AOSOA_HAS_AVX2
+    // One load per cache line of the block: unlike a prefetch, a load is
+    // never dropped when the miss buffers are full.
+    static inline void touch_block_impl(const BlockT* blk) {
+        const volatile char* p = reinterpret_cast<const volatile char*>(blk);
+        for (size_t off = 0; off < sizeof(BlockT); off += 64) (void)p[off];
+    }
+
+    // ---- sum_all_avx2 / compute_all_avx2 internals ----
+
+    // Blocks of lookahead for the generic reductions: ~4 KiB, the same
+    // distance as PF_AHEAD = 8 on a 512-byte float8 B=16 block.
+    static constexpr size_t avx2_pf_ahead = std::max<size_t>(1, 4096 / sizeof(BlockT));
+
+    template<size_t... Is>
+    reduce_t sum_all_avx2_impl(std::index_sequence<Is...>) const {
+        using VT = aosoa_detail::vec256<reduce_t>;
+        constexpr size_t L = VT::lanes;
+        const size_t nb = blocks.size();
+        if (nb == 0) return reduce_t(0);
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        typename VT::V acc[sizeof...(Ts)] = { ((void)Is, VT::zero())... };
+        reduce_t rest = 0;
+        auto run = [&](const BlockT& blk, size_t n) {
+            const size_t nv = n - n % L;
+            for (size_t i = 0; i < nv; i += L) {
+                ((acc[Is] = VT::add(acc[Is],
+                    aosoa_detail::load_widen<reduce_t>(std::get<Is>(blk.data).data() + i))), ...);
+            }
+            for (size_t i = nv; i < n; ++i) {
+                rest += (static_cast<reduce_t>(std::get<Is>(blk.data)[i]) + ...);
+            }
+        };
+        for_each_block_run(0, full, [&](const BlockT* blks, size_t nblk) {
+            for (size_t bi = 0; bi < nblk; ++bi) {
+                if (bi + avx2_pf_ahead < nblk) prefetch_block_impl(blks + bi + avx2_pf_ahead);
+                run(blks[bi], B);
+            }
+        });
+        if (tail > 0) run(blocks[full], tail);
+
+        typename VT::V total = VT::zero();
+        ((total = VT::add(total, acc[Is])), ...);
+        return VT::hsum(total) + rest;
+    }
+
+    // Js indexes the added fields 2..N-1.
+    template<size_t... Js>
+    reduce_t compute_all_avx2_impl(std::index_sequence<Js...>) const {
+        using VT = aosoa_detail::vec256<reduce_t>;
+        constexpr size_t L = VT::lanes;
+        const size_t nb = blocks.size();
+        if (nb == 0) return reduce_t(0);
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        typename VT::V acc_mul = VT::zero();
+        typename VT::V acc_sum[sizeof...(Js) + 1] = { ((void)Js, VT::zero())..., VT::zero() };
+        reduce_t rest = 0;
+        auto run = [&](const BlockT& blk, size_t n) {
+            const auto* x0 = std::get<0>(blk.data).data();
+            const auto* x1 = std::get<1>(blk.data).data();
+            const size_t nv = n - n % L;
+            for (size_t i = 0; i < nv; i += L) {
+                acc_mul = VT::fmadd(aosoa_detail::load_widen<reduce_t>(x0 + i),
+                                    aosoa_detail::load_widen<reduce_t>(x1 + i), acc_mul);
+                ((acc_sum[Js] = VT::add(acc_sum[Js],
+                    aosoa_detail::load_widen<reduce_t>(std::get<Js + 2>(blk.data).data() + i))), ...);
+            }
+            for (size_t i = nv; i < n; ++i) {
+                rest += static_cast<reduce_t>(x0[i]) * static_cast<reduce_t>(x1[i]);
+                rest = (rest + ... + static_cast<reduce_t>(std::get<Js + 2>(blk.data)[i]));
+            }
+        };
+        for_each_block_run(0, full, [&](const BlockT* blks, size_t nblk) {
+            for (size_t bi = 0; bi < nblk; ++bi) {
+                if (bi + avx2_pf_ahead < nblk) prefetch_block_impl(blks + bi + avx2_pf_ahead);
+                run(blks[bi], B);
+            }
+        });
+        if (tail > 0) run(blocks[full], tail);
+
+        typename VT::V total = acc_mul;
+        ((total = VT::add(total, acc_sum[Js])), ...);
+        return VT::hsum(total) + rest;
+    }
+
+#if AOSOA_HAS_AVX512
+    // Per-field fold of fields [F, N) into acc[F..N); lanes outside m read
+    // as zero. Full blocks pass an all-ones mask, which costs the same as a
+    // plain aligned load.
+    template<size_t F>
+    static inline void sum_block_avx512_impl(const BlockT& blk, __mmask16 m, __m512* acc) {
+        if constexpr (F < sizeof...(Ts)) {
+            acc[F] = _mm512_add_ps(acc[F], _mm512_maskz_load_ps(m, std::get<F>(blk.data).data()));
+            sum_block_avx512_impl<F + 1>(blk, m, acc);
+        }
+    }
+#endif
+
+    // ---- filter_simd helpers ----
+
+    // Bit i set iff mask[i], for the 8 bools at mask[0..8).
+    static inline unsigned mask_bits8(const bool* mask) {
+        const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_slli_epi16(v, 7)));
+    }
+
+    // Packs the lanes of src[0..8) selected by `bits` to the front of dst.
+    // Always writes all 8 slots of dst; slots past popcount(bits) are junk.
+    template<class T>
+    static inline void compact8(const T* src, unsigned bits, T* dst) {
+        if constexpr (sizeof(T) == 4) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+            const __m256i packed = _mm256_maskz_compress_epi32(static_cast<__mmask8>(bits), v);
+#else
+            const __m256i idx = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(aosoa_detail::compact_lut32[bits].data()));
+            const __m256i packed = _mm256_permutevar8x32_epi32(v, idx);
+#endif
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+        } else {
+#if defined(__AVX512F__)
+            const __m512i v = _mm512_loadu_si512(src);
+            _mm512_storeu_si512(dst, _mm512_maskz_compress_epi64(static_cast<__mmask8>(bits), v));
+#else
+            const unsigned lo_bits = bits & 0xFu;
+            const unsigned hi_bits = bits >> 4;
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4));
+            const __m256i lo_idx = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(aosoa_detail::compact_lut64[lo_bits].data()));
+            const __m256i hi_idx = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(aosoa_detail::compact_lut64[hi_bits].data()));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                                _mm256_permutevar8x32_epi32(lo, lo_idx));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + std::popcount(lo_bits)),
+                                _mm256_permutevar8x32_epi32(hi, hi_idx));
+#endif
+        }
+    }
+
+    // Appends the `cnt` lanes of src[0..8) selected by `bits` to field F of
+    // out at element (ob, oo). Packs straight into the output block when a
+    // whole 8-slot store fits; otherwise packs into a local stage and splits
+    // the copy across the block boundary (block ob + 1 must already exist).
+    template<size_t F, class T>
+    static inline void append_compacted(BasicAoSoA& out, size_t ob, size_t oo,
+                                        const T* src, unsigned bits, size_t cnt) {
+        T* dst = std::get<F>(out.blocks[ob].data).data();
+        if (oo + 8 <= B) {
+            compact8(src, bits, dst + oo);
+            return;
+        }
+        T stage[8];
+        compact8(src, bits, stage);
+        const size_t head = std::min(cnt, B - oo);
+        for (size_t k = 0; k < head; ++k) dst[oo + k] = stage[k];
+        T* next = std::get<F>(out.blocks[ob + 1].data).data();
+        for (size_t k = head; k < cnt; ++k) next[k - head] = stage[k];
+    }
+
+    template<class Pred, size_t... Is>
+    BasicAoSoA filter_simd_impl(Pred& pred, const allocator_type& out_alloc,
+                                std::index_sequence<Is...>) const {
+        BasicAoSoA out(out_alloc);
+        out.reserve(size_);
+        const size_t nb = blocks.size();
+        if (nb == 0) return out;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        size_t count = 0;
+        auto run = [&](const BlockT& blk, size_t n) {
+            alignas(16) bool mask[B];
+            for (size_t i = 0; i < n; ++i) {
+                mask[i] = pred(std::get<Is>(blk.data)[i]...);
+            }
+            for (size_t i = n; i < B; ++i) mask[i] = false;
+            for (size_t c = 0; c < B; c += 8) {
+                const unsigned bits = mask_bits8(mask + c);
+                if (bits == 0) continue;
+                const size_t cnt = static_cast<size_t>(std::popcount(bits));
+                const size_t ob = count / B;
+                const size_t oo = count % B;
+                while (out.blocks.size() < ob + ((oo + cnt > B) ? 2 : 1)) {
+                    out.blocks.emplace_back();
+                }
+                (append_compacted<Is>(out, ob, oo, std::get<Is>(blk.data).data() + c, bits, cnt), ...);
+                count += cnt;
+            }
+        };
+        for (size_t bi = 0; bi < full; ++bi) run(blocks[bi], B);
+        if (tail > 0)                        run(blocks[full], tail);
+        out.size_ = count;
+        return out;
+    }
+#endif // AOSOA_HAS_AVX2
+
+#if AOSOA_HAS_X86_DISPATCH
+    // ---- runtime-dispatch internals ----
+
+    // Byte offset of each field array inside a Block. The same for every
+    // block, so the ISA kernels compute it once and address fields as
+    // base + off[f] in plain loops (no lambdas: a lambda would not inherit
+    // the kernel's target attribute).
+    static std::array<size_t, sizeof...(Ts)> field_offsets(const BlockT& blk) {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            const char* base = reinterpret_cast<const char*>(&blk);
+            return std::array<size_t, sizeof...(Ts)>{ static_cast<size_t>(
+                reinterpret_cast<const char*>(std::get<Is>(blk.data).data()) - base)... };
+        }(std::index_sequence_for<Ts...>{});
+    }
+#endif
+
+#if AOSOA_HAS_STDX_SIMD
+    // ---- for_each_simd / reduce_simd internals ----
+
+    // Loads are vector_aligned only if every field array, and therefore
+    // every chunk inside it, lands on the widest pack alignment.
+    static constexpr bool simd_loads_aligned = [] {
+        if constexpr (is_simd_vectorizable) {
+            constexpr size_t a = std::max({ aosoa_detail::stdx::memory_alignment_v<simd_t<Ts>>... });
+            return a <= alignof(BlockT) && ((B * sizeof(Ts) % a == 0) && ...);
+        } else {
+            return false;
+        }
+    }();
+    using simd_flags_t = std::conditional_t<simd_loads_aligned,
+                                            aosoa_detail::stdx::vector_aligned_tag,
+                                            aosoa_detail::stdx::element_aligned_tag>;
+
+    // Lanes [0, n) active.
+    template<class T>
+    static auto simd_tail_mask(size_t n) {
+        return simd_t<T>([](auto l) { return static_cast<T>(l); }) < static_cast<T>(n);
+    }
+
+    // Full chunk at element i of blk: load, call, store back unless Blk is const.
+    template<class Blk, class F, size_t... Is>
+    static void simd_chunk(Blk& blk, size_t i, F& f, std::index_sequence<Is...>) {
+        std::tuple<simd_t<Ts>...> p{ simd_t<Ts>(std::get<Is>(blk.data).data() + i, simd_flags_t{})... };
+        f(std::get<Is>(p)...);
+        if constexpr (!std::is_const_v<Blk>) {
+            (std::get<Is>(p).copy_to(std::get<Is>(blk.data).data() + i, simd_flags_t{}), ...);
+        }
+    }
+
+    // Masked chunk: lanes [0, n) of element i onward.
+    template<class Blk, class F, size_t... Is>
+    static void simd_chunk_masked(Blk& blk, size_t i, size_t n, F& f, std::index_sequence<Is...>) {
+        namespace stdx = aosoa_detail::stdx;
+        std::tuple<simd_t<Ts>...> p{ simd_t<Ts>(Ts{})... };
+        (where(simd_tail_mask<Ts>(n), std::get<Is>(p))
+             .copy_from(std::get<Is>(blk.data).data() + i, stdx::element_aligned), ...);
+        f(std::get<Is>(p)...);
+        if constexpr (!std::is_const_v<Blk>) {
+            (where(simd_tail_mask<Ts>(n), std::get<Is>(p))
+                 .copy_to(std::get<Is>(blk.data).data() + i, stdx::element_aligned), ...);
+        }
+    }
+
+    template<class Blk, class F, size_t... Is>
+    static void simd_block(Blk& blk, size_t n, F& f, std::index_sequence<Is...> seq) {
+        size_t i = 0;
+        for (; i + simd_width <= n; i += simd_width) simd_chunk(blk, i, f, seq);
+        if (i < n)                                   simd_chunk_masked(blk, i, n - i, f, seq);
+    }
+
+    template<class F, size_t... Is>
+    void for_each_simd_impl(F& f, std::index_sequence<Is...> seq) {
+        for_each_block([&](BlockT& blk, size_t n) { simd_block(blk, n, f, seq); });
+    }
+    template<class F, size_t... Is>
+    void for_each_simd_impl(F& f, std::index_sequence<Is...> seq) const {
+        for_each_block([&](const BlockT& blk, size_t n) { simd_block(blk, n, f, seq); });
+    }
+
+    template<class Acc, class F, size_t... Is>
+    Acc reduce_simd_impl(Acc acc, F& f, std::index_sequence<Is...> seq) const {
+        using R = typename Acc::value_type;
+        auto full_body = [&](const auto&... xs) { acc = f(acc, xs...); };
+        for_each_block([&](const BlockT& blk, size_t n) {
+            size_t i = 0;
+            for (; i + simd_width <= n; i += simd_width) simd_chunk(blk, i, full_body, seq);
+            if (i < n) {
+                const size_t m = n - i;
+                auto masked_body = [&](const auto&... xs) {
+                    where(simd_tail_mask<R>(m), acc) = f(acc, xs...);
+                };
+                simd_chunk_masked(blk, i, m, masked_body, seq);
+            }
+        });
+        return acc;
+    }
+#endif // AOSOA_HAS_STDX_SIMD
+
+    // Base of the block sequence for the unrolled / multistream walks: a raw
+    // BlockT* over the vector, a random-access cursor over a paged store.
+    auto block_base() {
+        if constexpr (aosoa_detail::block_store<Alloc, BlockT>::contiguous) return blocks.data();
+        else return blocks.begin();
+    }
+    auto block_base() const {
+        if constexpr (aosoa_detail::block_store<Alloc, BlockT>::contiguous) return blocks.data();
+        else return blocks.begin();
+    }
+
+    // Calls run(p, n) for each contiguous run of blocks p[0..n) covering
+    // [first, last): one run over the vector, one per page over a paged
+    // store. Loops written against the run keep the plain pointer shape
+    // GCC vectorizes; indexing a paged store block by block would put a
+    // page-table load inside the loop and, for reduce, defeats it.
+    template<class Run>
+    void for_each_block_run(size_t first, size_t last, Run&& run) {
+        if constexpr (aosoa_detail::block_store<Alloc, BlockT>::contiguous) {
+            if (first < last) run(blocks.data() + first, last - first);
+        } else {
+            constexpr size_t mask = block_store_type::page_mask;
+            while (first < last) {
+                const size_t stop = std::min(last, (first | mask) + 1);
+                run(&blocks[first], stop - first);
+                first = stop;
+            }
+        }
+    }
+    template<class Run>
+    void for_each_block_run(size_t first, size_t last, Run&& run) const {
+        if constexpr (aosoa_detail::block_store<Alloc, BlockT>::contiguous) {
+            if (first < last) run(blocks.data() + first, last - first);
+        } else {
+            constexpr size_t mask = block_store_type::page_mask;
+            while (first < last) {
+                const size_t stop = std::min(last, (first | mask) + 1);
+                run(&blocks[first], stop - first);
+                first = stop;
+            }
+        }
+    }
+
+    // ---- for_each / reduce / filter internals ----
+
+    // Policy traversal core behind for_each / for_each_unrolled /
+    // for_each_multistream / for_each_field / reduce / filter. It visits
+    // every block once as body(blk, n), where n is integral_constant<B> for
+    // the full blocks (the element loop in body keeps the constant trip count
+    // GCC vectorizes) and the element count for the partial tail block.
+    // Self is BasicAoSoA or const BasicAoSoA, so one body serves both.
+    //
+    // streams<K> splits the full blocks into K segments of full/K blocks and
+    // visits one block of each per step. The K addresses are
+    // (full/K) * sizeof(BlockT) bytes apart, far enough that the L2 streamer
+    // allocates K independent trackers: AoSoA gets the multi-stream memory
+    // parallelism SOA gets for free from its N field arrays. Blocks past
+    // K * (full/K) run as one stream. unroll<U> makes U back-to-back copies
+    // of a step per outer iteration; each copy is its own lambda inside the
+    // fold, which keeps GCC from merging them while it still vectorizes each
+    // one. prefetch<D> prefetches the lines of fields PF of the block D
+    // ahead in the same stream, for as long as that block is in the stream.
+    //
+    // With one stream the blocks go run by run (for_each_block_run), so a
+    // paged store keeps the plain pointer loop.
+    template<class P, class Self, class Body, size_t... PF>
+    static void traverse(Self& self, Body&& body, std::index_sequence<PF...>) {
+        constexpr size_t U = P::unroll, K = P::streams, D = P::prefetch;
+        const size_t nb = self.blocks.size();
+        if (nb == 0) return;
+        const size_t tail = self.size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        constexpr std::integral_constant<size_t, B> whole{};
+
+        auto walk = [&](auto p, size_t n) {
+            size_t bi = 0;
+            if constexpr (U >= 2) {
+                for (; bi + U <= n; bi += U) {
+                    [&]<size_t... Us>(std::index_sequence<Us...>) {
+                        ((
+                            [&] {
+                                if constexpr (D > 0) {
+                                    if (bi + Us + D < n) prefetch_fields_impl<PF...>(p[bi + Us + D]);
+                                }
+                                body(p[bi + Us], whole);
+                            }()
+                        ), ...);
+                    }(std::make_index_sequence<U>{});
+                }
+            }
+            for (; bi < n; ++bi) {
+                if constexpr (D > 0) {
+                    if (bi + D < n) prefetch_fields_impl<PF...>(p[bi + D]);
+                }
+                body(p[bi], whole);
+            }
+        };
+
+        if constexpr (K >= 2) {
+            const size_t seg = full / K;
+            const auto base = self.block_base();
+            // Block j of each of the K streams.
+            auto step = [&](size_t j) {
+                [&]<size_t... Ks>(std::index_sequence<Ks...>) {
+                    ((
+                        [&] {
+                            if constexpr (D > 0) {
+                                if (j + D < seg) prefetch_fields_impl<PF...>(base[Ks * seg + j + D]);
+                            }
+                            body(base[Ks * seg + j], whole);
+                        }()
+                    ), ...);
+                }(std::make_index_sequence<K>{});
+            };
+            size_t bi = 0;
+            if constexpr (U >= 2) {
+                for (; bi + U <= seg; bi += U) {
+                    [&]<size_t... Us>(std::index_sequence<Us...>) {
+                        (step(bi + Us), ...);
+                    }(std::make_index_sequence<U>{});
+                }
+            }
+            for (; bi < seg; ++bi) step(bi);
+            self.for_each_block_run(K * seg, full, walk);
+        } else {
+            self.for_each_block_run(0, full, walk);
+        }
+        if (tail > 0) body(self.blocks[full], tail);
+    }
+
+    // Every cache line of fields PF... in blk. A field array need not start
+    // on a line, so the walk starts from the line holding its first byte.
+    template<size_t... PF>
+    static void prefetch_fields_impl(const BlockT& blk) {
+        auto lines = [](const void* p, size_t bytes) {
+            const auto first = reinterpret_cast<uintptr_t>(p);
+            for (uintptr_t a = first & ~uintptr_t{63}; a < first + bytes; a += 64) {
+                __builtin_prefetch(reinterpret_cast<const void*>(a), 0, 3);
+            }
+        };
+        (lines(std::get<PF>(blk.data).data(), sizeof(std::get<PF>(blk.data))), ...);
+    }
+
+    template<class P, class Self, class F, size_t... Sel>
+    static void for_each_policy_impl(Self& self, F& f, std::index_sequence<Sel...> sel) {
+        traverse<P>(self, [&](auto& blk, auto n) {
+            for (size_t i = 0; i < n; ++i) {
+                f(std::get<Sel>(blk.data)[i]...);
+            }
+        }, sel);
+    }
+
+    template<class F, size_t... Is>
+    void for_each_indexed_impl(F&& f, std::index_sequence<Is...>) {
+        const size_t nb = blocks.size();
         if (nb == 0) return;
         const size_t tail = size_ % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
         for (size_t bi = 0; bi < full; ++bi) {
             auto& blk = blocks[bi];
+            const size_t base = bi * B;
             for (size_t i = 0; i < B; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
+                f(base + i, std::get<Is>(blk.data)[i]...);
             }
         }
         if (tail > 0) {
             auto& blk = blocks[full];
+            const size_t base = full * B;
             for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
+                f(base + i, std::get<Is>(blk.data)[i]...);
+            }
+        }
+    }
+
+    // Threads actually used for nthreads requested: never more than there
+    // are blocks, so tiny containers do not wake idle workers.
+    size_t par_threads(size_t nthreads) const {
+        return std::clamp<size_t>(nthreads, 1, std::max<size_t>(blocks.size(), 1));
+    }
+
+    // Drives body(t, first, last, tail) on each of par_threads(nthreads)
+    // threads over the block ranges from block_range(). `tail` is the
+    // element count of block `last` that the thread must also process
+    // (non-zero only for the last range).
+    template<class Body>
+    void run_block_ranges(size_t nthreads, Body&& body) const {
+        const size_t nb = blocks.size();
+        if (nb == 0) return;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        const size_t nt = par_threads(nthreads);
+        WorkerPool::global().run(nt, [&](size_t t) {
+            const auto [first, last] = block_range(t, nt, full);
+            body(t, first, last, (t == nt - 1) ? tail : 0);
+        });
+    }
+
+    template<class F, size_t... Sel>
+    void for_each_par_impl(F& f, size_t nthreads, std::index_sequence<Sel...>) {
+        run_block_ranges(nthreads, [&](size_t, size_t first, size_t last, size_t tail) {
+            for (size_t bi = first; bi < last; ++bi) {
+                auto& blk = blocks[bi];
+                for (size_t i = 0; i < B; ++i) {
+                    f(std::get<Sel>(blk.data)[i]...);
+                }
+            }
+            if (tail > 0) {
+                auto& blk = blocks[last];
+                for (size_t i = 0; i < tail; ++i) {
+                    f(std::get<Sel>(blk.data)[i]...);
+                }
+            }
+        });
+    }
+
+    template<class F, size_t... Sel>
+    void for_each_par_impl(F& f, size_t nthreads, std::index_sequence<Sel...>) const {
+        run_block_ranges(nthreads, [&](size_t, size_t first, size_t last, size_t tail) {
+            for (size_t bi = first; bi < last; ++bi) {
+                const auto& blk = blocks[bi];
+                for (size_t i = 0; i < B; ++i) {
+                    f(std::get<Sel>(blk.data)[i]...);
+                }
+            }
+            if (tail > 0) {
+                const auto& blk = blocks[last];
+                for (size_t i = 0; i < tail; ++i) {
+                    f(std::get<Sel>(blk.data)[i]...);
+                }
+            }
+        });
+    }
+
+    // Each block folds into a local copy of acc: when traverse is not
+    // inlined (several streams make it large) acc itself is only reachable
+    // through the body's capture, and a float accumulator GCC must assume
+    // the block loads may alias is neither kept in a register nor vectorized.
+    template<class P, class Acc, class F, size_t... Sel>
+    Acc reduce_policy_impl(Acc acc, F& f, std::index_sequence<Sel...> sel) const {
+        traverse<P>(*this, [&](const BlockT& blk, auto n) {
+            acc = reduce_block_impl<P, Sel...>(blk, n, std::move(acc), f);
+        }, sel);
+        return acc;
+    }
+
+    // One block's fold. n stays an integral_constant on full blocks so the
+    // single-stream loop keeps its compile-time trip count. With K > 1
+    // stream copies in one step, unroll 1 keeps each loop a loop until the
+    // vectorizer has seen it: GCC otherwise peels every copy completely
+    // first, and SLP cannot vectorize the scalar reduction chain left
+    // behind (streams<8> ran 2x slower in cache).
+    template<class P, size_t... Sel, class N, class Acc, class F>
+    static Acc reduce_block_impl(const BlockT& blk, N n, Acc a, F& f) {
+        if constexpr (P::streams > 1) {
+            const size_t m = n;
+#pragma GCC unroll 1
+            for (size_t i = 0; i < m; ++i) {
+                a = f(a, std::get<Sel>(blk.data)[i]...);
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                a = f(a, std::get<Sel>(blk.data)[i]...);
+            }
+        }
+        return a;
+    }
+
+    template<class Acc, class F, class C, size_t... Is>
+    Acc reduce_par_impl(Acc init, F& f, C& combine, size_t nthreads,
+                        std::index_sequence<Is...>) const {
+        if (blocks.empty()) return init;
+        struct alignas(64) Partial { Acc v; };
+        const size_t nt = par_threads(nthreads);
+        std::vector<Partial> part(nt, Partial{init});
+        run_block_ranges(nt, [&](size_t t, size_t first, size_t last, size_t tail) {
+            Acc acc = init;
+            for (size_t bi = first; bi < last; ++bi) {
+                const auto& blk = blocks[bi];
+                for (size_t i = 0; i < B; ++i) {
+                    acc = f(acc, std::get<Is>(blk.data)[i]...);
+                }
+            }
+            if (tail > 0) {
+                const auto& blk = blocks[last];
+                for (size_t i = 0; i < tail; ++i) {
+                    acc = f(acc, std::get<Is>(blk.data)[i]...);
+                }
+            }
+            part[t].v = std::move(acc);
+        });
+        for (size_t stride = 1; stride < nt; stride *= 2) {
+            for (size_t t = 0; t + stride < nt; t += 2 * stride) {
+                part[t].v = combine(std::move(part[t].v), std::move(part[t + stride].v));
+            }
+        }
+        return std::move(part[0].v);
+    }
+
+    // Two-phase per block: pred over the Sel fields fills a bool mask
+    // (vectorizes), then scalar compaction copies whole survivors. Prefetch,
+    // if any, covers every field, since survivors are copied whole.
+    template<class P, class Pred, size_t... Sel>
+    BasicAoSoA filter_policy_impl(Pred& pred, const allocator_type& out_alloc,
+                                  std::index_sequence<Sel...>) const {
+        static_assert(P::streams == 1, "filter keeps element order, so it takes no streams policy");
+        BasicAoSoA out(out_alloc);
+        out.reserve(size_);
+        traverse<P>(*this, [&](const BlockT& blk, auto n) {
+            bool mask[B];
+            for (size_t i = 0; i < n; ++i) {
+                mask[i] = pred(std::get<Sel>(blk.data)[i]...);
+            }
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (mask[i]) {
+                        out.push_back(std::get<Is>(blk.data)[i]...);
+                    }
+                }
+            }(std::index_sequence_for<Ts...>{});
+        }, std::index_sequence_for<Ts...>{});
+        return out;
+    }
+
+    template<class Pred, size_t... Is>
+    void filter_into_impl(Pred& pred, BasicAoSoA& out, StoreMode mode,
+                          std::index_sequence<Is...>) const {
+        const size_t nb = blocks.size();
+        if (out.blocks.size() < nb) out.blocks.resize(nb);
+        const bool nt = aosoa_detail::use_streaming(mode, nb * sizeof(BlockT));
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        BlockT stage{};
+        size_t ob = 0, oo = 0;
+        auto run = [&](const BlockT& blk, size_t n) {
+            bool mask[B];
+            for (size_t i = 0; i < n; ++i) {
+                mask[i] = pred(std::get<Is>(blk.data)[i]...);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (!mask[i]) continue;
+                auto& dst = nt ? stage : out.blocks[ob];
+                ((std::get<Is>(dst.data)[oo] = std::get<Is>(blk.data)[i]), ...);
+                if (++oo == B) {
+                    if (nt) aosoa_detail::stream_copy(&out.blocks[ob], &stage, sizeof(BlockT));
+                    oo = 0;
+                    ++ob;
+                }
+            }
+        };
+        for (size_t bi = 0; bi < full; ++bi) run(blocks[bi], B);
+        if (tail > 0)                        run(blocks[full], tail);
+        if (nt) {
+            if (oo > 0) {
+                auto& dst = out.blocks[ob];
+                ((std::copy_n(std::get<Is>(stage.data).data(), oo, std::get<Is>(dst.data).data())), ...);
             }
+            aosoa_detail::stream_fence();
         }
+        out.size_ = ob * B + oo;
+        out.blocks.resize((out.size_ + B - 1) / B);
+    }
+
+    template<class R, class F, size_t... Is>
+    void transform_impl(F& f, R* out, StoreMode mode, std::index_sequence<Is...>) const {
+        const size_t nb = blocks.size();
+        if (nb == 0) return;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        if (!aosoa_detail::use_streaming(mode, size_ * sizeof(R))) {
+            for (size_t bi = 0; bi < full; ++bi) {
+                const auto& blk = blocks[bi];
+                R* __restrict__ o = out + bi * B;
+                for (size_t i = 0; i < B; ++i) o[i] = f(std::get<Is>(blk.data)[i]...);
+            }
+            if (tail > 0) {
+                const auto& blk = blocks[full];
+                R* __restrict__ o = out + full * B;
+                for (size_t i = 0; i < tail; ++i) o[i] = f(std::get<Is>(blk.data)[i]...);
+            }
+            return;
+        }
+
+        constexpr size_t stage_blocks = std::max<size_t>(1, 4096 / (B * sizeof(R)));
+        alignas(64) R buf[stage_blocks * B];
+        for (size_t b0 = 0; b0 < full; b0 += stage_blocks) {
+            const size_t nblk = std::min(stage_blocks, full - b0);
+            for (size_t k = 0; k < nblk; ++k) {
+                const auto& blk = blocks[b0 + k];
+                R* __restrict__ o = buf + k * B;
+                for (size_t i = 0; i < B; ++i) o[i] = f(std::get<Is>(blk.data)[i]...);
+            }
+            aosoa_detail::stream_copy(out + b0 * B, buf, nblk * B * sizeof(R));
+        }
+        if (tail > 0) {
+            const auto& blk = blocks[full];
+            for (size_t i = 0; i < tail; ++i) buf[i] = f(std::get<Is>(blk.data)[i]...);
+            aosoa_detail::stream_copy(out + full * B, buf, tail * sizeof(R));
+        }
+        aosoa_detail::stream_fence();
+    }
+
+    template<class Pred, size_t... Is>
+    size_t erase_if_impl(Pred& pred, std::index_sequence<Is...>) {
+        const size_t nb = blocks.size();
+        if (nb == 0) return 0;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+
+        size_t wb = 0, wo = 0;   // write cursor (block, offset), never ahead of the read
+        auto run = [&](size_t bi, size_t n) {
+            auto& blk = blocks[bi];
+            bool keep[B];
+            for (size_t i = 0; i < n; ++i) {
+                keep[i] = !pred(std::get<Is>(blk.data)[i]...);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (!keep[i]) continue;
+                if (wb != bi || wo != i) {
+                    auto& dst = blocks[wb];
+                    ((std::get<Is>(dst.data)[wo] = std::get<Is>(blk.data)[i]), ...);
+                }
+                if (++wo == B) { wo = 0; ++wb; }
+            }
+        };
+        for (size_t bi = 0; bi < full; ++bi) run(bi, B);
+        if (tail > 0)                        run(full, tail);
+
+        const size_t kept = wb * B + wo;
+        const size_t removed = size_ - kept;
+        resize(kept);
+        return removed;
+    }
+
+    template<class Pred, size_t... Is>
+    size_t erase_if_unordered_impl(Pred& pred, std::index_sequence<Is...>) {
+        size_t n = size_;
+        size_t i = 0;
+        while (i < n) {
+            auto& blk = blocks[i / B];
+            const size_t o = i % B;
+            if (!pred(std::get<Is>(blk.data)[o]...)) { ++i; continue; }
+            --n;
+            if (i != n) {
+                const auto& last = blocks[n / B];
+                ((std::get<Is>(blk.data)[o] = std::get<Is>(last.data)[n % B]), ...);
+            }
+        }
+        const size_t removed = size_ - n;
+        resize(n);
+        return removed;
+    }
+
+    template<class Pred, size_t... Is>
+    BasicAoSoA filter_par_impl(Pred& pred, const allocator_type& out_alloc, size_t nthreads,
+                               std::index_sequence<Is...>) const {
+        BasicAoSoA out(out_alloc);
+        if (blocks.empty()) return out;
+        struct alignas(64) Count { size_t v; };
+        const size_t nt = par_threads(nthreads);
+        std::vector<Count> offset(nt, Count{0});
+
+        // Pass 1: survivors per block range.
+        run_block_ranges(nt, [&](size_t t, size_t first, size_t last, size_t tail) {
+            size_t cnt = 0;
+            for (size_t bi = first; bi < last; ++bi) {
+                const auto& blk = blocks[bi];
+                for (size_t i = 0; i < B; ++i) {
+                    cnt += pred(std::get<Is>(blk.data)[i]...) ? 1 : 0;
+                }
+            }
+            if (tail > 0) {
+                const auto& blk = blocks[last];
+                for (size_t i = 0; i < tail; ++i) {
+                    cnt += pred(std::get<Is>(blk.data)[i]...) ? 1 : 0;
+                }
+            }
+            offset[t].v = cnt;
+        });
+
+        // Exclusive scan: counts -> output offsets.
+        size_t total = 0;
+        for (auto& o : offset) { const size_t c = o.v; o.v = total; total += c; }
+        out.resize(total);
+
+        // Pass 2: scatter survivors from each range to its offset. Two
+        // threads may write disjoint elements of the same output block where
+        // their ranges meet; that is the only sharing.
+        run_block_ranges(nt, [&](size_t t, size_t first, size_t last, size_t tail) {
+            size_t ob = offset[t].v / B;
+            size_t oo = offset[t].v % B;
+            auto emit = [&](const BlockT& blk, size_t i) {
+                auto& dst = out.blocks[ob];
+                ((std::get<Is>(dst.data)[oo] = std::get<Is>(blk.data)[i]), ...);
+                if (++oo == B) { oo = 0; ++ob; }
+            };
+            for (size_t bi = first; bi < last; ++bi) {
+                const auto& blk = blocks[bi];
+                for (size_t i = 0; i < B; ++i) {
+                    if (pred(std::get<Is>(blk.data)[i]...)) emit(blk, i);
+                }
+            }
+            if (tail > 0) {
+                const auto& blk = blocks[last];
+                for (size_t i = 0; i < tail; ++i) {
+                    if (pred(std::get<Is>(blk.data)[i]...)) emit(blk, i);
+                }
+            }
+        });
+        return out;
+    }
+
+    template<class U, class Acc, class F, class C, class Pred, size_t... Is>
+    Acc update_reduce_filter_par_impl(U& update, Acc init, F& f, C& combine, Pred& keep,
+                                      BasicAoSoA& out, size_t nthreads, size_t chunk_bytes,
+                                      std::index_sequence<Is...>) {
+        const size_t nb = blocks.size();
+        out.resize(size_);
+        if (nb == 0) return init;
+        const size_t tail = size_ % B;
+        const size_t full = (tail == 0) ? nb : nb - 1;
+        const size_t cb = std::max<size_t>(chunk_bytes / sizeof(BlockT), 1);
+        const size_t nchunks = (nb + cb - 1) / cb;
+        struct alignas(64) Partial { Acc v; };
+        struct alignas(64) End { std::atomic<size_t> v; };
+        constexpr size_t not_ready = ~size_t{0};
+        std::vector<Partial> part(nchunks, Partial{init});
+        std::unique_ptr<End[]> out_end(new End[nchunks]);
+        for (size_t c = 0; c < nchunks; ++c) out_end[c].v.store(not_ready, std::memory_order_relaxed);
+        std::atomic<size_t> next{0};
+
+        const size_t nt = std::clamp<size_t>(nthreads, 1, nchunks);
+        WorkerPool::global().run(nt, [&](size_t) {
+            // keep's verdicts for the current chunk, from the counting pass:
+            // the scatter must write exactly the cnt survivors it announced.
+            std::unique_ptr<bool[]> mask(new bool[cb * B]);
+            for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < nchunks;) {
+                const size_t first = c * cb;
+                const size_t last  = std::min(first + cb, nb);
+                const size_t split = std::min(last, full);
+                // body(blk, n) over the chunk's blocks; n is the constant B
+                // for full blocks so their loops keep a fixed trip count.
+                auto each_block = [&](auto&& body) {
+                    for (size_t bi = first; bi < split; ++bi)
+                        body(blocks[bi], std::integral_constant<size_t, B>{});
+                    if (split < last) body(blocks[split], tail);
+                };
+
+                each_block([&](BlockT& blk, auto n) {
+                    for (size_t i = 0; i < n; ++i) update(std::get<Is>(blk.data)[i]...);
+                });
+                Acc acc = init;
+                size_t cnt = 0;
+                size_t m = 0;
+                each_block([&](const BlockT& blk, auto n) {
+                    // Built on the stack and copied out: storing straight
+                    // into mask from this loop keeps GCC from vectorizing it.
+                    bool mb[B];
+                    for (size_t i = 0; i < n; ++i) {
+                        acc = f(acc, std::get<Is>(blk.data)[i]...);
+                        mb[i] = keep(std::get<Is>(blk.data)[i]...);
+                    }
+                    for (size_t i = 0; i < n; ++i) cnt += mb[i];
+                    std::memcpy(mask.get() + m, mb, n);
+                    m += n;
+                });
+                part[c].v = std::move(acc);
+
+                size_t start = 0;
+                if (c > 0) {
+                    while ((start = out_end[c - 1].v.load(std::memory_order_acquire)) == not_ready)
+                        std::this_thread::yield();
+                }
+                out_end[c].v.store(start + cnt, std::memory_order_release);
+
+                // Scatter, as in filter_par: neighbouring chunks may write
+                // disjoint elements of one output block.
+                size_t ob = start / B;
+                size_t oo = start % B;
+                m = 0;
+                each_block([&](const BlockT& blk, auto n) {
+                    for (size_t i = 0; i < n; ++i) {
+                        if (!mask[m + i]) continue;
+                        auto& dst = out.blocks[ob];
+                        ((std::get<Is>(dst.data)[oo] = std::get<Is>(blk.data)[i]), ...);
+                        if (++oo == B) { oo = 0; ++ob; }
+                    }
+                    m += n;
+                });
+            }
+        });
+
+        out.resize(out_end[nchunks - 1].v.load(std::memory_order_relaxed));
+        for (size_t stride = 1; stride < nchunks; stride *= 2) {
+            for (size_t c = 0; c + stride < nchunks; c += 2 * stride) {
+                part[c].v = combine(std::move(part[c].v), std::move(part[c + stride].v));
+            }
+        }
+        return std::move(part[0].v);
+    }
+
+    template<size_t... Is>
+    Proxy make_proxy_at(size_t bi, size_t off, std::index_sequence<Is...>) {
+        return Proxy{{ std::get<Is>(blocks[bi].data)[off]... }};
+    }
+
+    // ---- bulk append internals ----
+
+    template<size_t... Is>
+    void append_fields(const std::tuple<const Ts*...>& src, size_t count, std::index_sequence<Is...>) {
+        blocks.resize((size_ + count + B - 1) / B);
+        write_fields(size_, src, count, std::index_sequence<Is...>{});
+        size_ += count;
+    }
+
+    // Copies the first n elements of blk to element position pos; the block
+    // store must already cover [pos, pos + n).
+    void write_block(size_t pos, const BlockT& blk, size_t n) {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            write_fields(pos, std::tuple<const Ts*...>{std::get<Is>(blk.data).data()...}, n,
+                         std::index_sequence<Is...>{});
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    // Top up the block holding pos, then whole blocks, then the remainder.
+    template<size_t... Is>
+    void write_fields(size_t pos, const std::tuple<const Ts*...>& src, size_t count,
+                      std::index_sequence<Is...>) {
+        size_t bi = pos / B;
+        size_t off = pos % B;
+        size_t done = 0;
+        while (done < count) {
+            const size_t k = std::min(B - off, count - done);
+            auto& blk = blocks[bi];
+            // A whole block is one fixed-size memcpy per field. The pieces of
+            // a top-up are short copies of runtime length, where an inline
+            // loop beats a call to memcpy.
+            if (k == B) {
+                (aosoa_detail::copy_elems(std::get<Is>(blk.data).data(), std::get<Is>(src) + done, B), ...);
+            } else {
+                ([&] {
+                    auto* __restrict__ d = std::get<Is>(blk.data).data() + off;
+                    const auto* __restrict__ sp = std::get<Is>(src) + done;
+                    for (size_t i = 0; i < k; ++i) d[i] = sp[i];
+                }(), ...);
+            }
+            done += k;
+            off = 0;
+            ++bi;
+        }
+    }
+
+    template<typename Tuple, size_t... Is>
+    static void write_at(BlockT& b, size_t off, Tuple&& t, std::index_sequence<Is...>) {
+        ((std::get<Is>(b.data)[off] = std::get<Is>(t)), ...);
+    }
+};
+
+template<size_t B, typename... Ts>
+using AoSoA = BasicAoSoA<B, std::allocator<std::byte>, Ts...>;
+
+template<size_t B, typename... Ts>
+using SegmentedAoSoA = BasicAoSoA<B, SegmentedStorage<>, Ts...>;
+
+// Recommended default block size.
+//
+// Empirical sweep across B ∈ {2, 4, 8, 16, 32, 64, 128}, 4 type configurations
+// (float3, float8, double3, int+float+double), 5 sizes (1K to 1M), 4 ops
+// (Read, Write, Compute, FilterCopy) on Intel Core Ultra 7 (12 MiB L3, AVX2).
+//
+// B=16 minimizes geometric-mean slowdown across all 80 workloads (1.097x vs
+// oracle best-B), has the lowest worst-case (1.79x) of any single default,
+// and wins 30/80 cells outright — more than any other B. Detailed study:
+// see the SOA vs AoSoA blog post.
+template<typename... Ts>
+using AoSoAd = AoSoA<16, Ts...>;
+
+// Block-size policy.
+//
+// Block is alignas(64), so a B whose field arrays do not add up to whole
+// cache lines pays for it in padding: AoSoA<2, float, float, float> holds
+// 24 B of payload in a 64 B block. BlockLayout<B, Ts...> reports that cost
+// at compile time, and two policies choose B from the field types:
+//
+//   AoSoAAuto<Ts...>        the smallest B for which every field array is
+//                           a whole number of cache lines, so each array
+//                           starts on a line and the block has no padding.
+//                           float3/float8/int+float+double get 16,
+//                           double3 gets 8.
+//   AoSoAFit<Lines, Ts...>  the largest B whose block fits in Lines cache
+//                           lines: a multiple of the AoSoAAuto B when one
+//                           fits, otherwise the largest padded B that does.
+template<size_t B, typename... Ts>
+struct BlockLayout {
+    static constexpr size_t line_bytes    = 64;
+    static constexpr size_t payload_bytes = B * (sizeof(Ts) + ...);
+    static constexpr size_t block_bytes   = sizeof(Block<B, Ts...>);
+    static constexpr size_t padding_bytes = block_bytes - payload_bytes;
+    static constexpr size_t lines         = block_bytes / line_bytes;
+    static constexpr double wasted_per_element = double(padding_bytes) / double(B);
+    // Every field array fills whole lines and nothing is padded.
+    static constexpr bool line_exact =
+        ((B * sizeof(Ts) % line_bytes == 0) && ...) && padding_bytes == 0;
+};
+
+namespace aosoa_detail {
+template<typename... Ts>
+constexpr size_t line_exact_block_size() {
+    size_t b = 1;
+    ((b = std::lcm(b, size_t(64) / std::gcd(size_t(64), sizeof(Ts)))), ...);
+    return b;
+}
+
+template<size_t Lines, typename... Ts>
+constexpr size_t fit_block_size() {
+    constexpr size_t exact = line_exact_block_size<Ts...>();
+    constexpr size_t exact_lines = BlockLayout<exact, Ts...>::lines;
+    if constexpr (Lines >= exact_lines) {
+        return exact * (Lines / exact_lines);
+    } else {
+        return []<size_t... Bs>(std::index_sequence<Bs...>) {
+            size_t best = 0;
+            ((BlockLayout<Bs + 1, Ts...>::lines <= Lines ? best = Bs + 1 : best), ...);
+            return best;
+        }(std::make_index_sequence<exact>{});
+    }
+}
+} // namespace aosoa_detail
+
+template<typename... Ts>
+inline constexpr size_t auto_block_size = aosoa_detail::line_exact_block_size<Ts...>();
+
+template<size_t Lines, typename... Ts>
+inline constexpr size_t fit_block_size = aosoa_detail::fit_block_size<Lines, Ts...>();
+
+template<typename... Ts>
+using AoSoAAuto = AoSoA<auto_block_size<Ts...>, Ts...>;
+
+template<size_t Lines, typename... Ts>
+using AoSoAFit = AoSoA<fit_block_size<Lines, Ts...>, Ts...>;
+
+// FieldGroup: a compile-time list of fields that BasicGroupedAoSoA keeps in
+// one block vector of their own.
+template<typename... Ts>
+struct FieldGroup {
+    static constexpr size_t size = sizeof...(Ts);
+};
+
+namespace aosoa_detail {
+template<size_t B, class Alloc, class G> struct group_aosoa;
+template<size_t B, class Alloc, class... Ts>
+struct group_aosoa<B, Alloc, FieldGroup<Ts...>> {
+    using type   = BasicAoSoA<B, Alloc, Ts...>;
+    using fields = std::tuple<Ts...>;
+};
+} // namespace aosoa_detail
+
+// GroupedAoSoA: AoSoA with hot/cold field groups.
+//
+// Each FieldGroup is a BasicAoSoA<B, Alloc, group fields...> with its own
+// block vector; element e sits at block e / B, lane e % B of every group.
+// Fields are numbered in declaration order across all groups, and
+// for_each_field<Is...> / reduce_field<Is...> walk only the groups that hold
+// one of Is. A kernel on positions and velocities then streams just their
+// blocks, without pulling the cold mass/life lines through the cache or
+// spending prefetcher streams on them. The price is one stream per group
+// for a kernel that touches several groups.
+//
+//   GroupedAoSoA<16, FieldGroup<float, float, float, float, float, float>,  // pos, vel
+//                    FieldGroup<float>, FieldGroup<float>> p;               // mass | life
+//   p.for_each_field<0, 1, 2, 3, 4, 5>([dt](auto& x, auto& y, auto& z,
+//                                           auto& vx, auto& vy, auto& vz) { ... });
+//
+// group<G>() exposes group G as a plain BasicAoSoA for its own kernels
+// (sum_all_avx2, filter, ...); resizing one group on its own breaks the
+// shared indexing.
+template<size_t B, class Alloc, class... Groups>
+class BasicGroupedAoSoA {
+    static_assert(sizeof...(Groups) > 0, "GroupedAoSoA needs at least one FieldGroup");
+public:
+    using groups_type = std::tuple<typename aosoa_detail::group_aosoa<B, Alloc, Groups>::type...>;
+    using fields_type = decltype(std::tuple_cat(
+        std::declval<typename aosoa_detail::group_aosoa<B, Alloc, Groups>::fields>()...));
+    static constexpr size_t field_count = std::tuple_size_v<fields_type>;
+    static constexpr size_t group_count = sizeof...(Groups);
+
+    groups_type groups;
+
+    template<size_t G> auto& group()             { return std::get<G>(groups); }
+    template<size_t G> const auto& group() const { return std::get<G>(groups); }
+
+    size_t size() const       { return std::get<0>(groups).size(); }
+    size_t num_blocks() const { return std::get<0>(groups).num_blocks(); }
+
+    void resize(size_t n)  { std::apply([n](auto&... g) { (g.resize(n), ...); }, groups); }
+    void reserve(size_t n) { std::apply([n](auto&... g) { (g.reserve(n), ...); }, groups); }
+
+    // One value per field, in global field order.
+    template<typename... Args>
+    void push_back(Args&&... args) {
+        static_assert(sizeof...(Args) == field_count, "push_back takes one value per field");
+        auto t = std::forward_as_tuple(std::forward<Args>(args)...);
+        [&]<size_t... Gs>(std::index_sequence<Gs...>) {
+            (push_back_group<Gs>(t, std::make_index_sequence<group_size[Gs]>{}), ...);
+        }(std::make_index_sequence<group_count>{});
+    }
+
+    template<class F>
+    void for_each(F&& f) {
+        for_each_field_seq(*this, f, std::make_index_sequence<field_count>{});
+    }
+    template<class F>
+    void for_each(F&& f) const {
+        for_each_field_seq(*this, f, std::make_index_sequence<field_count>{});
+    }
+
+    // f(refs...) for the selected fields only; untouched groups are not read.
+    template<size_t... Is, class F>
+    void for_each_field(F&& f) {
+        static_assert(sizeof...(Is) > 0, "for_each_field needs at least one field");
+        for_each_field_impl<Is...>(*this, f);
+    }
+    template<size_t... Is, class F>
+    void for_each_field(F&& f) const {
+        static_assert(sizeof...(Is) > 0, "for_each_field needs at least one field");
+        for_each_field_impl<Is...>(*this, f);
+    }
+
+    template<class Acc, class F>
+    Acc reduce(Acc init, F&& f) const {
+        return reduce_field_seq(std::move(init), f, std::make_index_sequence<field_count>{});
+    }
+
+    template<size_t... Is, class Acc, class F>
+    Acc reduce_field(Acc init, F&& f) const {
+        static_assert(sizeof...(Is) > 0, "reduce_field needs at least one field");
+        return reduce_field_impl<Is...>(std::move(init), f);
+    }
+
+    // In-place cull, as BasicAoSoA::erase_if: pred sees the selected fields
+    // (all of them for erase_if) and every group is compacted with the same
+    // mask, so survivors keep their order and their shared index.
+    template<class Pred>
+    size_t erase_if(Pred&& pred) {
+        return erase_if_field_seq(pred, std::make_index_sequence<field_count>{});
+    }
+
+    template<size_t... Is, class Pred>
+    size_t erase_if_field(Pred&& pred) {
+        static_assert(sizeof...(Is) > 0, "erase_if_field needs at least one field");
+        return erase_if_field_impl<Is...>(pred);
+    }
+
+private:
+    static constexpr std::array<size_t, group_count> group_size = { Groups::size... };
+    static constexpr std::array<size_t, group_count + 1> group_first = [] {
+        std::array<size_t, group_count + 1> a{};
+        for (size_t g = 0; g < group_count; ++g) a[g + 1] = a[g] + group_size[g];
+        return a;
+    }();
+    static constexpr size_t group_of(size_t I) {
+        size_t g = 0;
+        while (group_first[g + 1] <= I) ++g;
+        return g;
+    }
+    template<size_t I> static constexpr size_t group_v = group_of(I);
+    template<size_t I> static constexpr size_t lane_v  = I - group_first[group_of(I)];
+
+    // Field I's array in block bi.
+    template<size_t I> auto& field_array(size_t bi) {
+        return std::get<lane_v<I>>(std::get<group_v<I>>(groups).blocks[bi].data);
+    }
+    template<size_t I> const auto& field_array(size_t bi) const {
+        return std::get<lane_v<I>>(std::get<group_v<I>>(groups).blocks[bi].data);
+    }
+
+    template<size_t G, class Tuple, size_t... Js>
+    void push_back_group(Tuple& t, std::index_sequence<Js...>) {
+        std::get<G>(groups).push_back(std::get<group_first[G] + Js>(t)...);
+    }
+
+    // Copy element (bi, i) to the write cursor (wb, wo) in every group.
+    template<size_t... Gs>
+    void move_lane(size_t wb, size_t wo, size_t bi, size_t i, std::index_sequence<Gs...>) {
+        ([&](auto& grp) {
+            auto& dst = grp.blocks[wb];
+            auto& src = grp.blocks[bi];
+            std::apply([&](auto&... d) {
+                std::apply([&](auto&... s) { ((d[wo] = s[i]), ...); }, src.data);
+            }, dst.data);
+        }(std::get<Gs>(groups)), ...);
+    }
+
+    template<class Self, class F, size_t... Is>
+    static void for_each_field_seq(Self& self, F& f, std::index_sequence<Is...>) {
+        for_each_field_impl<Is...>(self, f);
+    }
+    template<class Acc, class F, size_t... Is>
+    Acc reduce_field_seq(Acc init, F& f, std::index_sequence<Is...>) const {
+        return reduce_field_impl<Is...>(std::move(init), f);
     }
+    template<class Pred, size_t... Is>
+    size_t erase_if_field_seq(Pred& pred, std::index_sequence<Is...>) { return erase_if_field_impl<Is...>(pred); }
 
-    template<class F, size_t... Is>
-    void for_each_const_impl(F&& f, std::index_sequence<Is...>) const {
-        const size_t nb = blocks.size();
+    // Shared by the const and non-const overloads: Self's constness picks
+    // the field_array overload, and with it what f is handed.
+    template<size_t... Is, class Self, class F>
+    static void for_each_field_impl(Self& self, F& f) {
+        const size_t nb = self.num_blocks();
         if (nb == 0) return;
-        const size_t tail = size_ % B;
+        const size_t tail = self.size() % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
         for (size_t bi = 0; bi < full; ++bi) {
-            const auto& blk = blocks[bi];
-            for (size_t i = 0; i < B; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
-        }
-        if (tail > 0) {
-            const auto& blk = blocks[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
+            for (size_t i = 0; i < B; ++i) f(self.template field_array<Is>(bi)[i]...);
         }
+        for (size_t i = 0; i < tail; ++i) f(self.template field_array<Is>(full)[i]...);
     }
 
-    template<size_t UNROLL, class F, size_t... Is>
-    void for_each_unrolled_impl(F&& f, std::index_sequence<Is...>) {
-        static_assert(UNROLL >= 1, "UNROLL must be >= 1");
-        const size_t nb = blocks.size();
-        if (nb == 0) return;
-        const size_t tail = size_ % B;
+    template<size_t... Is, class Acc, class F>
+    Acc reduce_field_impl(Acc acc, F& f) const {
+        const size_t nb = num_blocks();
+        if (nb == 0) return acc;
+        const size_t tail = size() % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
-
-        BlockT* const blk_base = blocks.data();
-        size_t bi = 0;
-        if constexpr (UNROLL >= 2) {
-            for (; bi + UNROLL <= full; bi += UNROLL) {
-                BlockT* __restrict__ const b0 = blk_base + bi;
-                // The `Us` fold produces UNROLL back-to-back copies of the
-                // baseline inner loop. Writing each as a lambda inside the
-                // fold keeps GCC from merging them, while still letting it
-                // vectorize each copy independently.
-                [&]<size_t... Us>(std::index_sequence<Us...>) {
-                    ((
-                        [&] {
-                            auto& blk = b0[Us];
-                            for (size_t i = 0; i < B; ++i) {
-                                f(std::get<Is>(blk.data)[i]...);
-                            }
-                        }()
-                    ), ...);
-                }(std::make_index_sequence<UNROLL>{});
-            }
-        }
-        for (; bi < full; ++bi) {
-            auto& blk = blocks[bi];
-            for (size_t i = 0; i < B; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
+        for (size_t bi = 0; bi < full; ++bi) {
+            for (size_t i = 0; i < B; ++i) acc = f(acc, field_array<Is>(bi)[i]...);
         }
-        if (tail > 0) {
-            auto& blk = blocks[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
+        for (size_t i = 0; i < tail; ++i) acc = f(acc, field_array<Is>(full)[i]...);
+        return acc;
+    }
+
+    template<size_t... Is, class Pred>
+    size_t erase_if_field_impl(Pred& pred) {
+        const size_t n = size();
+        const size_t nb = num_blocks();
+        if (nb == 0) return 0;
+        size_t wb = 0, wo = 0;   // write cursor, never ahead of the read
+        for (size_t bi = 0; bi < nb; ++bi) {
+            const size_t len = (bi + 1 < nb || n % B == 0) ? B : n % B;
+            bool keep[B];
+            for (size_t i = 0; i < len; ++i) keep[i] = !pred(field_array<Is>(bi)[i]...);
+            for (size_t i = 0; i < len; ++i) {
+                if (!keep[i]) continue;
+                if (wb != bi || wo != i) move_lane(wb, wo, bi, i, std::make_index_sequence<group_count>{});
+                if (++wo == B) { wo = 0; ++wb; }
             }
         }
+        const size_t kept = wb * B + wo;
+        resize(kept);
+        return n - kept;
     }
+};
 
-    template<size_t UNROLL, class F, size_t... Is>
-    void for_each_unrolled_const_impl(F&& f, std::index_sequence<Is...>) const {
-        static_assert(UNROLL >= 1, "UNROLL must be >= 1");
-        const size_t nb = blocks.size();
-        if (nb == 0) return;
-        const size_t tail = size_ % B;
-        const size_t full = (tail == 0) ? nb : nb - 1;
+template<size_t B, class... Groups>
+using GroupedAoSoA = BasicGroupedAoSoA<B, std::allocator<std::byte>, Groups...>;
 
-        const BlockT* const blk_base = blocks.data();
-        size_t bi = 0;
-        if constexpr (UNROLL >= 2) {
-            for (; bi + UNROLL <= full; bi += UNROLL) {
-                const BlockT* __restrict__ const b0 = blk_base + bi;
-                [&]<size_t... Us>(std::index_sequence<Us...>) {
-                    ((
-                        [&] {
-                            const auto& blk = b0[Us];
-                            for (size_t i = 0; i < B; ++i) {
-                                f(std::get<Is>(blk.data)[i]...);
-                            }
-                        }()
-                    ), ...);
-                }(std::make_index_sequence<UNROLL>{});
-            }
-        }
-        for (; bi < full; ++bi) {
-            const auto& blk = blocks[bi];
-            for (size_t i = 0; i < B; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
+// PackedBlock: a Block whose field layout is computed at compile time.
+//
+// Block's std::tuple<std::array<Ts, B>...> leaves field order and padding to
+// the tuple implementation. libstdc++ places the last field first, so in
+// <double, float, double> at B = 8 the second double array starts 32 B into
+// a line and straddles two. PackedBlock places the arrays itself:
+//   - widest alignment first, declaration order on ties, so no padding is
+//     needed between arrays;
+//   - an array of at least one cache line starts on a 64 B boundary,
+//     unless that would cost the block an extra line;
+//   - the block is the payload rounded up to whole lines, so it is never
+//     larger than Block<B, Ts...>.
+// field<I>() is a raw pointer at the compile-time offset<I>, tagged with
+// the alignment the layout guarantees; no std::get is involved.
+namespace aosoa_detail {
+template<size_t N>
+struct packed_layout_t {
+    std::array<size_t, N> offset{};
+    size_t bytes = 0;
+};
+
+template<size_t B, typename... Ts>
+constexpr auto packed_layout() {
+    constexpr size_t N = sizeof...(Ts);
+    constexpr size_t line = 64;
+    const std::array<size_t, N> bytes = { B * sizeof(Ts)... };
+    const std::array<size_t, N> align = { alignof(Ts)... };
+    auto up = [](size_t x, size_t a) { return (x + a - 1) / a * a; };
+
+    std::array<size_t, N> ord{};
+    for (size_t i = 0; i < N; ++i) ord[i] = i;
+    for (size_t i = 1; i < N; ++i) {
+        for (size_t j = i; j > 0 && align[ord[j]] > align[ord[j - 1]]; --j) {
+            std::swap(ord[j], ord[j - 1]);
         }
-        if (tail > 0) {
-            const auto& blk = blocks[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
+    }
+    // Packed back to back in that order the arrays need no padding, so
+    // this is the smallest block any layout can have.
+    size_t payload = 0;
+    for (size_t i = 0; i < N; ++i) payload += bytes[i];
+    const size_t limit = up(payload, line);
+
+    packed_layout_t<N> l;
+    size_t off = 0;
+    for (size_t k = 0; k < N; ++k) {
+        const size_t f = ord[k];
+        size_t at = up(off, align[f]);
+        if (bytes[f] >= line) {
+            size_t end = up(off, line) + bytes[f];
+            for (size_t r = k + 1; r < N; ++r) end = up(end, align[ord[r]]) + bytes[ord[r]];
+            if (up(end, line) <= limit) at = up(off, line);
         }
+        l.offset[f] = at;
+        off = at + bytes[f];
     }
+    l.bytes = up(off, line);
+    return l;
+}
+} // namespace aosoa_detail
 
-    // Multi-stream implementation — splits the block vector into K segments
-    // and iterates one block from each segment per outer iter. Segments are
-    // `full/K` blocks apart in the vector, so the load addresses are
-    // (full/K) * sizeof(BlockT) bytes apart in virtual memory — far enough
-    // that the L2 streamer must allocate K independent tracker slots.
-    //
-    // Fallbacks handle (a) K=1 or K>full, (b) leftover blocks past K*seg,
-    // (c) partial tail block.
-    template<size_t K, class F, size_t... Is>
-    void for_each_multistream_impl(F&& f, std::index_sequence<Is...>) {
-        static_assert(K >= 1, "K must be >= 1");
-        const size_t nb = blocks.size();
-        if (nb == 0) return;
-        const size_t tail = size_ % B;
-        const size_t full = (tail == 0) ? nb : nb - 1;
+template<size_t B, typename... Ts>
+struct alignas(64) PackedBlock {
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "PackedBlock stores fields as raw bytes");
+    static_assert(((alignof(Ts) <= 64) && ...), "PackedBlock aligns blocks to 64 bytes");
+
+    static constexpr auto layout = aosoa_detail::packed_layout<B, Ts...>();
+    static constexpr size_t bytes = layout.bytes;
+
+    template<size_t I> using field_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+    template<size_t I> static constexpr size_t offset = layout.offset[I];
+    // Largest power of two (up to a line) that divides offset<I>.
+    template<size_t I> static constexpr size_t field_align =
+        offset<I> == 0 ? 64 : std::min<size_t>(64, offset<I> & (~offset<I> + 1));
+
+    template<size_t I> field_type<I>* field() {
+        return std::assume_aligned<field_align<I>>(
+            std::launder(reinterpret_cast<field_type<I>*>(storage + offset<I>)));
+    }
+    template<size_t I> const field_type<I>* field() const {
+        return std::assume_aligned<field_align<I>>(
+            std::launder(reinterpret_cast<const field_type<I>*>(storage + offset<I>)));
+    }
 
-        BlockT* const blk_base = blocks.data();
+    std::byte storage[bytes];
+};
 
-        if constexpr (K >= 2) {
-            const size_t seg = full / K;
-            if (seg > 0) {
-                for (size_t bi = 0; bi < seg; ++bi) {
-                    [&]<size_t... Ks>(std::index_sequence<Ks...>) {
-                        ((
-                            [&] {
-                                auto& blk = blk_base[bi + Ks * seg];
-                                for (size_t i = 0; i < B; ++i) {
-                                    f(std::get<Is>(blk.data)[i]...);
-                                }
-                            }()
-                        ), ...);
-                    }(std::make_index_sequence<K>{});
-                }
-                for (size_t bi = K * seg; bi < full; ++bi) {
-                    auto& blk = blk_base[bi];
-                    for (size_t i = 0; i < B; ++i) {
-                        f(std::get<Is>(blk.data)[i]...);
-                    }
-                }
-            } else {
-                for (size_t bi = 0; bi < full; ++bi) {
-                    auto& blk = blk_base[bi];
-                    for (size_t i = 0; i < B; ++i) {
-                        f(std::get<Is>(blk.data)[i]...);
-                    }
-                }
-            }
-        } else {
-            for (size_t bi = 0; bi < full; ++bi) {
-                auto& blk = blk_base[bi];
-                for (size_t i = 0; i < B; ++i) {
-                    f(std::get<Is>(blk.data)[i]...);
-                }
-            }
-        }
+// PackedAoSoA: AoSoA over PackedBlock.
+//
+// Same element order and the same functional surface as the core of
+// BasicAoSoA: for_each / for_each_field / reduce / filter / erase_if /
+// for_each_block, plus get<I>(i) for single elements. Each kernel loads
+// the field pointers of a block once, then runs the lane loop over them.
+// Fields must be trivially copyable.
+template<size_t B, class Alloc, typename... Ts>
+class BasicPackedAoSoA {
+    static_assert(B > 0, "Block size must be positive");
+public:
+    using BlockT = PackedBlock<B, Ts...>;
+    using block_store_type = typename aosoa_detail::block_store<Alloc, BlockT>::type;
+    using allocator_type = typename block_store_type::allocator_type;
+    block_store_type blocks;
 
-        if (tail > 0) {
-            auto& blk = blk_base[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
-        }
+    static constexpr size_t block_size()  { return B; }
+    static constexpr size_t field_count() { return sizeof...(Ts); }
+
+    BasicPackedAoSoA() = default;
+    explicit BasicPackedAoSoA(size_t n) { resize(n); }
+    explicit BasicPackedAoSoA(const allocator_type& a) : blocks(a) {}
+    BasicPackedAoSoA(size_t n, const allocator_type& a) : blocks(a) { resize(n); }
+
+    allocator_type get_allocator() const { return blocks.get_allocator(); }
+
+    size_t size() const       { return size_; }
+    size_t num_blocks() const { return blocks.size(); }
+
+    void resize(size_t n) {
+        blocks.resize((n + B - 1) / B);
+        size_ = n;
     }
+    void reserve(size_t n) { blocks.reserve((n + B - 1) / B); }
+    void clear() { resize(0); }
 
-    template<size_t K, class F, size_t... Is>
-    void for_each_multistream_const_impl(F&& f, std::index_sequence<Is...>) const {
-        static_assert(K >= 1, "K must be >= 1");
-        const size_t nb = blocks.size();
-        if (nb == 0) return;
-        const size_t tail = size_ % B;
-        const size_t full = (tail == 0) ? nb : nb - 1;
+    template<size_t I> auto& get(size_t i)             { return blocks[i / B].template field<I>()[i % B]; }
+    template<size_t I> const auto& get(size_t i) const { return blocks[i / B].template field<I>()[i % B]; }
 
-        const BlockT* const blk_base = blocks.data();
+    template<typename... Args>
+    void push_back(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "push_back takes one value per field");
+        const size_t off = size_ % B;
+        if (off == 0) blocks.emplace_back();
+        auto& blk = blocks.back();
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((blk.template field<Is>()[off] = std::forward<Args>(args)), ...);
+        }(std::index_sequence_for<Ts...>{});
+        ++size_;
+    }
 
-        if constexpr (K >= 2) {
-            const size_t seg = full / K;
-            if (seg > 0) {
-                for (size_t bi = 0; bi < seg; ++bi) {
-                    [&]<size_t... Ks>(std::index_sequence<Ks...>) {
-                        ((
-                            [&] {
-                                const auto& blk = blk_base[bi + Ks * seg];
-                                for (size_t i = 0; i < B; ++i) {
-                                    f(std::get<Is>(blk.data)[i]...);
-                                }
-                            }()
-                        ), ...);
-                    }(std::make_index_sequence<K>{});
-                }
-                for (size_t bi = K * seg; bi < full; ++bi) {
-                    const auto& blk = blk_base[bi];
-                    for (size_t i = 0; i < B; ++i) {
-                        f(std::get<Is>(blk.data)[i]...);
-                    }
-                }
-            } else {
-                for (size_t bi = 0; bi < full; ++bi) {
-                    const auto& blk = blk_base[bi];
-                    for (size_t i = 0; i < B; ++i) {
-                        f(std::get<Is>(blk.data)[i]...);
-                    }
-                }
-            }
-        } else {
-            for (size_t bi = 0; bi < full; ++bi) {
-                const auto& blk = blk_base[bi];
-                for (size_t i = 0; i < B; ++i) {
-                    f(std::get<Is>(blk.data)[i]...);
-                }
-            }
-        }
+    template<class F>
+    void for_each(F&& f) {
+        for_each_impl(*this, f, std::index_sequence_for<Ts...>{});
+    }
+    template<class F>
+    void for_each(F&& f) const {
+        for_each_impl(*this, f, std::index_sequence_for<Ts...>{});
+    }
 
-        if (tail > 0) {
-            const auto& blk = blk_base[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Is>(blk.data)[i]...);
-            }
-        }
+    template<size_t... Is, class F>
+    void for_each_field(F&& f) {
+        static_assert(sizeof...(Is) > 0, "for_each_field needs at least one field");
+        for_each_impl(*this, f, std::index_sequence<Is...>{});
     }
 
-    template<class F, size_t... Is>
-    void for_each_indexed_impl(F&& f, std::index_sequence<Is...>) {
+    template<class Acc, class F>
+    Acc reduce(Acc init, F&& f) const {
+        return reduce_impl(std::move(init), f, std::index_sequence_for<Ts...>{});
+    }
+
+    // f(block, valid_count) for every block.
+    template<class F>
+    void for_each_block(F&& f) {
         const size_t nb = blocks.size();
         if (nb == 0) return;
         const size_t tail = size_ % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
-        for (size_t bi = 0; bi < full; ++bi) {
-            auto& blk = blocks[bi];
-            const size_t base = bi * B;
-            for (size_t i = 0; i < B; ++i) {
-                f(base + i, std::get<Is>(blk.data)[i]...);
-            }
-        }
-        if (tail > 0) {
-            auto& blk = blocks[full];
-            const size_t base = full * B;
-            for (size_t i = 0; i < tail; ++i) {
-                f(base + i, std::get<Is>(blk.data)[i]...);
-            }
-        }
+        for (size_t bi = 0; bi < full; ++bi) f(blocks[bi], B);
+        if (tail > 0)                        f(blocks[full], tail);
     }
 
-    template<size_t... Sel, class F>
-    void for_each_field_impl(F&& f) {
-        const size_t nb = blocks.size();
+    // Survivors in source order. The output is reserved once and written at
+    // a running cursor, one new block per B survivors.
+    template<class Pred>
+    BasicPackedAoSoA filter(Pred&& pred) const {
+        BasicPackedAoSoA out(get_allocator());
+        out.reserve(size_);
+        out.size_ = compact_into(out, pred);
+        return out;
+    }
+
+    // In-place cull, order kept. Returns the number removed.
+    template<class Pred>
+    size_t erase_if(Pred&& pred) {
+        const size_t n = size_;
+        auto keep = [&pred](const auto&... xs) { return !pred(xs...); };
+        resize(compact_into(*this, keep));
+        return n - size_;
+    }
+
+private:
+    size_t size_ = 0;
+
+    template<class Self, class F, size_t... Is>
+    static void for_each_impl(Self& self, F& f, std::index_sequence<Is...>) {
+        const size_t nb = self.blocks.size();
         if (nb == 0) return;
-        const size_t tail = size_ % B;
+        const size_t tail = self.size_ % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
-        for (size_t bi = 0; bi < full; ++bi) {
-            auto& blk = blocks[bi];
-            for (size_t i = 0; i < B; ++i) {
-                f(std::get<Sel>(blk.data)[i]...);
-            }
-        }
-        if (tail > 0) {
-            auto& blk = blocks[full];
-            for (size_t i = 0; i < tail; ++i) {
-                f(std::get<Sel>(blk.data)[i]...);
-            }
-        }
+        auto run = [&f](auto&& blk, auto n) {
+            [&](auto*... ps) {
+                for (size_t i = 0; i < n; ++i) f(ps[i]...);
+            }(blk.template field<Is>()...);
+        };
+        for (size_t bi = 0; bi < full; ++bi) run(self.blocks[bi], std::integral_constant<size_t, B>{});
+        if (tail > 0)                        run(self.blocks[full], tail);
     }
 
     template<class Acc, class F, size_t... Is>
-    Acc reduce_impl(Acc acc, F&& f, std::index_sequence<Is...>) const {
+    Acc reduce_impl(Acc acc, F& f, std::index_sequence<Is...>) const {
         const size_t nb = blocks.size();
         if (nb == 0) return acc;
         const size_t tail = size_ % B;
         const size_t full = (tail == 0) ? nb : nb - 1;
-        for (size_t bi = 0; bi < full; ++bi) {
-            const auto& blk = blocks[bi];
-            for (size_t i = 0; i < B; ++i) {
-                acc = f(acc, std::get<Is>(blk.data)[i]...);
-            }
-        }
-        if (tail > 0) {
-            const auto& blk = blocks[full];
-            for (size_t i = 0; i < tail; ++i) {
-                acc = f(acc, std::get<Is>(blk.data)[i]...);
-            }
-        }
+        auto run = [&](const BlockT& blk, auto n) {
+            [&](const auto*... ps) {
+                for (size_t i = 0; i < n; ++i) acc = f(acc, ps[i]...);
+            }(blk.template field<Is>()...);
+        };
+        for (size_t bi = 0; bi < full; ++bi) run(blocks[bi], std::integral_constant<size_t, B>{});
+        if (tail > 0)                        run(blocks[full], tail);
         return acc;
     }
 
-    template<class Pred, size_t... Is>
-    AoSoA filter_impl(Pred pred, std::index_sequence<Is...>) const {
-        AoSoA out;
-        out.reserve(size_);
+    // Copies the elements pred keeps to out, from index 0 on, and returns
+    // their count. out is either empty, and gets a block appended per B
+    // survivors, or *this, compacted in place: the write cursor never
+    // passes the read.
+    template<class Pred>
+    size_t compact_into(BasicPackedAoSoA& out, Pred& pred) const {
         const size_t nb = blocks.size();
-        if (nb == 0) return out;
-        const size_t tail = size_ % B;
-        const size_t full = (tail == 0) ? nb : nb - 1;
-
-        auto run = [&](const BlockT& blk, size_t n) {
-            bool mask[B];
-            for (size_t i = 0; i < n; ++i) {
-                mask[i] = pred(std::get<Is>(blk.data)[i]...);
-            }
-            for (size_t i = 0; i < n; ++i) {
-                if (mask[i]) {
-                    out.push_back(std::get<Is>(blk.data)[i]...);
+        size_t w = 0;
+        for (size_t bi = 0; bi < nb; ++bi) {
+            const size_t len = (bi + 1 < nb || size_ % B == 0) ? B : size_ % B;
+            const BlockT& src = blocks[bi];
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                bool keep[B];
+                for (size_t i = 0; i < len; ++i) keep[i] = pred(src.template field<Is>()[i]...);
+                for (size_t i = 0; i < len; ++i) {
+                    if (!keep[i]) continue;
+                    if (&out != this) {
+                        if (w % B == 0) out.blocks.emplace_back();
+                    } else if (w == bi * B + i) {
+                        ++w;
+                        continue;
+                    }
+                    BlockT& dst = out.blocks[w / B];
+                    ((dst.template field<Is>()[w % B] = src.template field<Is>()[i]), ...);
+                    ++w;
                 }
-            }
-        };
-        for (size_t bi = 0; bi < full; ++bi) run(blocks[bi], B);
-        if (tail > 0)                        run(blocks[full], tail);
-        return out;
-    }
-
-    template<size_t... Is>
-    Proxy make_proxy_at(size_t bi, size_t off, std::index_sequence<Is...>) {
-        return Proxy{{ std::get<Is>(blocks[bi].data)[off]... }};
-    }
-
-    template<typename Tuple, size_t... Is>
-    static void write_at(BlockT& b, size_t off, Tuple&& t, std::index_sequence<Is...>) {
-        ((std::get<Is>(b.data)[off] = std::get<Is>(t)), ...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+        return w;
     }
 };
 
-// Recommended default block size.
-//
-// Empirical sweep across B ∈ {2, 4, 8, 16, 32, 64, 128}, 4 type configurations
-// (float3, float8, double3, int+float+double), 5 sizes (1K to 1M), 4 ops
-// (Read, Write, Compute, FilterCopy) on Intel Core Ultra 7 (12 MiB L3, AVX2).
-//
-// B=16 minimizes geometric-mean slowdown across all 80 workloads (1.097x vs
-// oracle best-B), has the lowest worst-case (1.79x) of any single default,
-// and wins 30/80 cells outright — more than any other B. Detailed study:
-// see the SOA vs AoSoA blog post.
-template<typename... Ts>
-using AoSoAd = AoSoA<16, Ts...>;
+template<size_t B, typename... Ts>
+using PackedAoSoA = BasicPackedAoSoA<B, std::allocator<std::byte>, Ts...>;